@@ -3,21 +3,51 @@
 #include <curl/curl.h>
 #include <fcntl.h>
 #include <systemd/sd-event.h>
+#include <systemd/sd-journal.h>
 #include <unistd.h>
 
+#include <sys/eventfd.h>
+
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <optional>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <variant>
 #include <vector>
 
+#include "response_cache.hh"
+
 namespace fs = std::filesystem;
 
 namespace aur {
 
+class AurImpl;
+
+namespace {
+
+class ResponseHandler;
+class RpcResponseHandler;
+class RpcParseWorkerPool;
+
+struct CachedRpcDispatch {
+  AurImpl* aur;
+  Aur::RpcResponseCallback callback;
+  ResponseCache::Entry entry;
+};
+
+}  // namespace
+
 class AurImpl : public Aur {
  public:
   explicit AurImpl(Options options = Options());
@@ -29,19 +59,38 @@ class AurImpl : public Aur {
   AurImpl(AurImpl&&) = default;
   AurImpl& operator=(AurImpl&&) = default;
 
-  void QueueRpcRequest(const RpcRequest& request,
-                       const RpcResponseCallback& callback) override;
+  int QueueRpcRequest(const RpcRequest& request,
+                      const RpcResponseCallback& callback) override;
 
   void QueueRawRequest(const HttpRequest& request,
                        const RawResponseCallback& callback) override;
 
+  void QueueStreamingRawRequest(const HttpRequest& request,
+                                const RawChunkSink& sink,
+                                const RawResponseCallback& callback) override;
+
   void QueueCloneRequest(const CloneRequest& request,
                          const CloneResponseCallback& callback) override;
 
+  void QueueLsRemoteRequest(const LsRemoteRequest& request,
+                            const LsRemoteResponseCallback& callback) override;
+
   // Wait for all pending requests to complete. Returns non-zero if any request
   // failed or was cancelled by a callback.
   int Wait() override;
 
+  Stats stats() const override { return stats_; }
+
+  // Lazily sets up the off-thread parser pool and its completion event
+  // source. Returns false if that fails, in which case responses must be
+  // parsed inline.
+  bool EnsureParsePool();
+
+  // Hands a completed RPC response body to the parser pool, to be parsed off
+  // the I/O thread and dispatched from the event loop.
+  void SubmitParse(RpcResponseHandler* handler, std::string body, long status,
+                   std::string error);
+
  private:
   using ActiveRequests =
       std::unordered_set<std::variant<CURL*, sd_event_source*>>;
@@ -51,9 +100,22 @@ class AurImpl : public Aur {
       const HttpRequest& request,
       const typename ResponseHandlerType::CallbackType& callback);
 
+  void StartHttpRequest(const std::string& url, ResponseHandler* handler,
+                        const std::string& post_payload = std::string());
+  void QueueCachedRpcResponse(ResponseCache::Entry entry,
+                              const RpcResponseCallback& callback);
+
+  void StartCloneRequest(const std::string& reponame,
+                         const CloneResponseCallback& callback);
+  void StartLsRemoteRequest(const std::string& reponame,
+                            const LsRemoteResponseCallback& callback);
+  void MaybeStartNextGitJob();
+
   int FinishRequest(CURL* curl, CURLcode result, bool dispatch_callback);
   int FinishRequest(sd_event_source* source);
 
+  void RecordTransferStats(CURL* curl, long response_code);
+
   int CheckFinished();
   void CancelAll();
   void Cancel(const ActiveRequests::value_type& request);
@@ -81,12 +143,36 @@ class AurImpl : public Aur {
   static int OnCurlTimer(sd_event_source* s, uint64_t usec, void* userdata);
   static int OnCloneExit(sd_event_source* s, const siginfo_t* si,
                          void* userdata);
+  static int OnLsRemoteExit(sd_event_source* s, const siginfo_t* si,
+                            void* userdata);
+  static int OnCachedResponse(sd_event_source* s, void* userdata);
+  static int OnParseDone(sd_event_source* s, int fd, uint32_t revents,
+                         void* userdata);
 
   Options options_;
+  std::optional<ResponseCache> cache_;
+
+  // In-flight RPC transfers by URL. Identical concurrent requests attach
+  // their callbacks to the existing transfer instead of starting another.
+  std::unordered_map<std::string, RpcResponseHandler*> in_flight_rpcs_;
+
+  // Parses RPC bodies off the I/O thread. Created on first use; results are
+  // re-injected into the event loop through parse_done_fd_.
+  std::unique_ptr<RpcParseWorkerPool> parse_pool_;
+  sd_event_source* parse_done_source_ = nullptr;
+  int parse_done_fd_ = -1;
+  int pending_parses_ = 0;
 
   CURLM* curl_multi_;
+  CURLSH* curl_share_ = nullptr;
+  curl_slist* post_headers_ = nullptr;
   ActiveRequests active_requests_;
 
+  // Git child processes (clones and ls-remote probes) beyond the configured
+  // parallelism limit wait here and are dispatched as running ones exit.
+  std::deque<std::function<void()>> queued_git_jobs_;
+  int active_git_jobs_ = 0;
+
   sigset_t saved_ss_{};
   sd_event* event_ = nullptr;
   sd_event_source* timer_ = nullptr;
@@ -94,6 +180,8 @@ class AurImpl : public Aur {
 
   DebugLevel debug_level_ = DebugLevel::NONE;
   std::ofstream debug_stream_;
+
+  Stats stats_;
 };
 
 namespace {
@@ -132,20 +220,73 @@ class ResponseHandler {
   static size_t BodyCallback(char* ptr, size_t size, size_t nmemb,
                              void* userdata) {
     auto* handler = static_cast<ResponseHandler*>(userdata);
+    return handler->OnBodyBytes(ptr, size * nmemb);
+  }
+
+  // Accumulates the body in memory. Handlers that can consume the response
+  // incrementally override this to avoid the buffering.
+  virtual size_t OnBodyBytes(char* ptr, size_t len) {
+    if (body.empty() && curl != nullptr) {
+      // Size the buffer up front when the server announces a Content-Length,
+      // avoiding reallocation churn on multi-megabyte responses. For
+      // compressed transfers this is the encoded size, which still serves as
+      // a useful lower bound.
+      curl_off_t content_length;
+      if (curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,
+                            &content_length) == CURLE_OK &&
+          content_length > 0) {
+        body.reserve(content_length);
+      }
+    }
 
-    handler->body.append(ptr, size * nmemb);
-    return size * nmemb;
+    body.append(ptr, len);
+    return len;
   }
 
-  static int DebugCallback(CURL*, curl_infotype type, char* data, size_t size,
-                           void* userdata) {
+  static int DebugCallback(CURL* curl, curl_infotype type, char* data,
+                           size_t size, void* userdata) {
     auto* stream = static_cast<std::ofstream*>(userdata);
+    const std::string_view text(data, size);
+
+    ResponseHandler* handler;
+    curl_easy_getinfo(curl, CURLINFO_PRIVATE, &handler);
+
+    switch (type) {
+      case CURLINFO_HEADER_OUT:
+        // A POST's request line names only the endpoint; the argument list
+        // follows separately as the request body. Hold the headers back and
+        // splice the body into the request target as it streams past, so the
+        // logged request reads the same whether it went out as a GET or a
+        // POST.
+        if (text.starts_with("POST ")) {
+          handler->debug_request_.assign(text);
+          handler->debug_request_.insert(handler->debug_request_.find(" HTTP/"),
+                                         "&");
+        } else {
+          stream->write(data, size);
+        }
+        break;
 
-    if (type != CURLINFO_HEADER_OUT) {
-      return 0;
+      case CURLINFO_DATA_OUT:
+        if (!handler->debug_request_.empty()) {
+          handler->debug_request_.insert(handler->debug_request_.find(" HTTP/"),
+                                         data, size);
+        }
+        break;
+
+      case CURLINFO_HEADER_IN:
+        // The response arriving marks the request as fully sent.
+        if (!handler->debug_request_.empty()) {
+          stream->write(handler->debug_request_.data(),
+                        handler->debug_request_.size());
+          handler->debug_request_.clear();
+        }
+        break;
+
+      default:
+        break;
     }
 
-    stream->write(data, size);
     return 0;
   }
 
@@ -155,15 +296,25 @@ class ResponseHandler {
     return r;
   }
 
+  // Gives the handler a chance to take over dispatch of its own callback
+  // asynchronously. Returns true if it has done so; the handler then owns
+  // its own lifetime and RunCallback must not be invoked.
+  virtual bool DispatchAsync(long, const std::string&) { return false; }
+
   AurImpl* aur() const { return aur_; }
 
   std::string body;
+  CURL* curl = nullptr;
   std::array<char, CURL_ERROR_SIZE> error_buffer = {};
 
  private:
   virtual int Run(long status, const std::string& error) = 0;
 
   AurImpl* aur_;
+
+  // Partially assembled request record for DebugCallback; only used for
+  // POSTs, whose request line and body arrive in separate callbacks.
+  std::string debug_request_;
 };
 
 template <typename ResponseT>
@@ -185,25 +336,148 @@ class TypedResponseHandler : public ResponseHandler {
   const CallbackType callback_;
 };
 
-class RpcResponseHandler : public TypedResponseHandler<RpcResponse> {
+class RpcResponseHandler : public ResponseHandler {
  public:
-  using TypedResponseHandler<RpcResponse>::TypedResponseHandler;
+  using CallbackType = Aur::RpcResponseCallback;
+
+  RpcResponseHandler(AurImpl* aur, CallbackType callback, ResponseCache* cache,
+                     std::string url,
+                     std::unordered_map<std::string, RpcResponseHandler*>*
+                         in_flight)
+      : ResponseHandler(aur),
+        cache_(cache),
+        url_(std::move(url)),
+        in_flight_(in_flight) {
+    callbacks_.push_back(std::move(callback));
+  }
+
+  ~RpcResponseHandler() override {
+    if (in_flight_ != nullptr) {
+      in_flight_->erase(url_);
+    }
+  }
+
+  void AddCallback(CallbackType callback) {
+    callbacks_.push_back(std::move(callback));
+  }
+
+  bool DispatchAsync(long status, const std::string& error) override {
+    if (!aur()->EnsureParsePool()) {
+      return false;
+    }
+
+    OnTransferDone(status, error);
+    aur()->SubmitParse(this, std::move(body), status, error);
+    return true;
+  }
+
+  // Invoked from the event loop with responses parsed by the worker pool,
+  // one per registered callback. Consumes the handler.
+  int DispatchParsed(std::vector<RpcResponse> responses, long status,
+                     const std::string& error) {
+    int r = 0;
+    for (size_t i = 0; i < callbacks_.size(); ++i) {
+      const int cr =
+          callbacks_[i](ResponseWrapper(std::move(responses[i]), status, error));
+      if (cr < 0) {
+        r = cr;
+      }
+    }
+
+    delete this;
+    return r;
+  }
+
+  size_t num_callbacks() const { return callbacks_.size(); }
+
+ private:
+  // Stops accepting further callbacks for this URL and handles the response
+  // cache. Must be called exactly once, when the transfer has completed.
+  void OnTransferDone(long status, const std::string& error) {
+    if (in_flight_ != nullptr) {
+      in_flight_->erase(url_);
+      in_flight_ = nullptr;
+    }
 
- protected:
-  int Run(long status, const std::string& error) override {
     if (status != 200) {
       // The AUR might supply HTML on non-200 replies. We must avoid parsing
       // this as JSON, so drop the response body and trust the callback to do
       // the right thing with the error.
       body.clear();
+    } else if (cache_ != nullptr && error.empty()) {
+      cache_->Put(url_, body);
+    }
+  }
+
+  int Run(long status, const std::string& error) override {
+    OnTransferDone(status, error);
+
+    int r = 0;
+    for (const auto& callback : callbacks_) {
+      const int cr = callback(ResponseWrapper(RpcResponse(body), status, error));
+      if (cr < 0) {
+        r = cr;
+      }
     }
 
-    return TypedResponseHandler<RpcResponse>::Run(status, error);
+    return r;
   }
+
+  ResponseCache* cache_;
+  std::string url_;
+  std::unordered_map<std::string, RpcResponseHandler*>* in_flight_;
+  std::vector<CallbackType> callbacks_;
 };
 
 using RawResponseHandler = TypedResponseHandler<RawResponse>;
 
+// Forwards body chunks of a successful transfer to a sink as they arrive.
+// Anything other than a 200 falls back to buffering, so error bodies are
+// still available to the completion callback.
+class StreamingRawResponseHandler : public RawResponseHandler {
+ public:
+  StreamingRawResponseHandler(AurImpl* aur, Aur::RawResponseCallback callback,
+                              Aur::RawChunkSink sink)
+      : RawResponseHandler(aur, std::move(callback)), sink_(std::move(sink)) {}
+
+ private:
+  size_t OnBodyBytes(char* ptr, size_t len) override {
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+
+    if (status != 200) {
+      return ResponseHandler::OnBodyBytes(ptr, len);
+    }
+
+    sink_(std::string_view(ptr, len));
+    return len;
+  }
+
+  Aur::RawChunkSink sink_;
+};
+
+class LsRemoteResponseHandler : public TypedResponseHandler<LsRemoteResponse> {
+ public:
+  using TypedResponseHandler::TypedResponseHandler;
+
+  ~LsRemoteResponseHandler() override {
+    if (pipe_fd >= 0) {
+      close(pipe_fd);
+    }
+  }
+
+  // Read end of the pipe connected to git's stdout, drained once the
+  // process has exited.
+  int pipe_fd = -1;
+
+ protected:
+  LsRemoteResponse MakeResponse() override {
+    // Output is a single "<hash>\tHEAD" line; anything past the hash is
+    // noise.
+    return LsRemoteResponse(body.substr(0, body.find_first_of(" \t\n")));
+  }
+};
+
 class CloneResponseHandler : public TypedResponseHandler<CloneResponse> {
  public:
   CloneResponseHandler(AurImpl* aur, Aur::CloneResponseCallback callback,
@@ -220,14 +494,154 @@ class CloneResponseHandler : public TypedResponseHandler<CloneResponse> {
   std::string operation_;
 };
 
+// Parses RPC response bodies on a small pool of worker threads so that a
+// large response doesn't stall socket I/O on the event loop thread. Finished
+// results are queued and the notify fd is signalled; the event loop drains
+// them via AurImpl::OnParseDone.
+class RpcParseWorkerPool {
+ public:
+  struct Result {
+    RpcResponseHandler* handler;
+    std::vector<RpcResponse> responses;
+    long status;
+    std::string error;
+  };
+
+  explicit RpcParseWorkerPool(int notify_fd) : notify_fd_(notify_fd) {
+    const auto num_threads =
+        std::max(1u, std::min(std::thread::hardware_concurrency(), 4u));
+    for (unsigned int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this] { Work(); });
+    }
+  }
+
+  ~RpcParseWorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cond_.notify_all();
+
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  RpcParseWorkerPool(const RpcParseWorkerPool&) = delete;
+  RpcParseWorkerPool& operator=(const RpcParseWorkerPool&) = delete;
+
+  void Submit(RpcResponseHandler* handler, std::string body,
+              size_t num_callbacks, long status, std::string error) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(
+          {handler, std::move(body), num_callbacks, status, std::move(error)});
+    }
+    cond_.notify_one();
+  }
+
+  std::deque<Result> TakeResults() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::exchange(results_, {});
+  }
+
+ private:
+  struct Job {
+    RpcResponseHandler* handler;
+    std::string body;
+    size_t num_callbacks;
+    long status;
+    std::string error;
+  };
+
+  void Work() {
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+          return;
+        }
+
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+      }
+
+      // RpcResponse is move-only, so parse once per callback that's waiting
+      // on this body.
+      Result result{job.handler, {}, job.status, std::move(job.error)};
+      result.responses.reserve(job.num_callbacks);
+      for (size_t i = 0; i < job.num_callbacks; ++i) {
+        result.responses.emplace_back(job.body);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(std::move(result));
+      }
+
+      uint64_t one = 1;
+      while (write(notify_fd_, &one, sizeof(one)) < 0 && errno == EINTR) {
+      }
+    }
+  }
+
+  int notify_fd_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stopping_ = false;
+  std::deque<Job> jobs_;
+  std::deque<Result> results_;
+  std::vector<std::thread> threads_;
+};
+
 }  // namespace
 
 AurImpl::AurImpl(Options options) : options_(std::move(options)) {
+  if (!options_.cachedir.empty()) {
+    cache_.emplace(options_.cachedir, options_.cache_ttl);
+  }
+
   curl_global_init(CURL_GLOBAL_SSL);
   curl_multi_ = curl_multi_init();
 
+  // All access happens on the event loop thread, so no lock callbacks are
+  // needed on the share handle.
+  curl_share_ = curl_share_init();
+  curl_share_setopt(curl_share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  curl_share_setopt(curl_share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(curl_share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+
   curl_multi_setopt(curl_multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
-  curl_multi_setopt(curl_multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, 5L);
+
+  // Suppress curl's Expect: 100-continue handshake on larger POST bodies.
+  // The RPC endpoint never rejects a request on its headers alone, so the
+  // extra round trip (or its 1 second fallback timeout) is pure loss.
+  post_headers_ = curl_slist_append(nullptr, "Expect:");
+
+  // Stay polite against the rate-limited public AUR, but widen the pool for
+  // anything else -- a private mirror has no reason to be throttled to 5
+  // connections.
+  long max_total = options_.max_total_connections;
+  if (max_total == 0) {
+    max_total =
+        options_.baseurl.find("//aur.archlinux.org") != std::string::npos ? 5
+                                                                          : 16;
+  }
+  curl_multi_setopt(curl_multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, max_total);
+
+  if (options_.max_host_connections > 0) {
+    curl_multi_setopt(curl_multi_, CURLMOPT_MAX_HOST_CONNECTIONS,
+                      static_cast<long>(options_.max_host_connections));
+  }
+
+#if LIBCURL_VERSION_NUM >= 0x074300 /* 7.67.0 */
+  if (options_.max_concurrent_streams > 0) {
+    curl_multi_setopt(curl_multi_, CURLMOPT_MAX_CONCURRENT_STREAMS,
+                      static_cast<long>(options_.max_concurrent_streams));
+  }
+#endif
 
   curl_multi_setopt(curl_multi_, CURLMOPT_SOCKETFUNCTION,
                     &AurImpl::SocketCallback);
@@ -253,7 +667,17 @@ AurImpl::AurImpl(Options options) : options_(std::move(options)) {
 }
 
 AurImpl::~AurImpl() {
+  // Join the parser threads before tearing anything else down; they may
+  // still be writing to the notify fd.
+  parse_pool_.reset();
+  sd_event_source_unref(parse_done_source_);
+  if (parse_done_fd_ >= 0) {
+    close(parse_done_fd_);
+  }
+
   curl_multi_cleanup(curl_multi_);
+  curl_share_cleanup(curl_share_);
+  curl_slist_free_all(post_headers_);
   curl_global_cleanup();
 
   sd_event_source_unref(timer_);
@@ -284,6 +708,8 @@ void AurImpl::Cancel(const ActiveRequests::value_type& request) {
 }
 
 void AurImpl::CancelAll() {
+  queued_git_jobs_.clear();
+
   while (!active_requests_.empty()) {
     Cancel(*active_requests_.begin());
   }
@@ -424,6 +850,8 @@ int AurImpl::FinishRequest(CURL* curl, CURLcode result,
     long response_code;
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
 
+    RecordTransferStats(curl, response_code);
+
     std::string error;
     if (result != CURLE_OK) {
       error = handler->error_buffer.data();
@@ -432,7 +860,9 @@ int AurImpl::FinishRequest(CURL* curl, CURLcode result,
       }
     }
 
-    r = handler->RunCallback(response_code, error);
+    if (!handler->DispatchAsync(response_code, error)) {
+      r = handler->RunCallback(response_code, error);
+    }
   } else {
     delete handler;
   }
@@ -444,6 +874,47 @@ int AurImpl::FinishRequest(CURL* curl, CURLcode result,
   return r;
 }
 
+void AurImpl::RecordTransferStats(CURL* curl, long response_code) {
+  curl_off_t namelookup = 0;
+  curl_off_t connect = 0;
+  curl_off_t appconnect = 0;
+  curl_off_t starttransfer = 0;
+  curl_off_t total = 0;
+  curl_off_t size = 0;
+  curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &namelookup);
+  curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+  curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appconnect);
+  curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &starttransfer);
+  curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+  curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &size);
+
+  ++stats_.requests;
+  stats_.bytes_received += size;
+  stats_.namelookup += std::chrono::microseconds(namelookup);
+  stats_.connect += std::chrono::microseconds(connect);
+  stats_.appconnect += std::chrono::microseconds(appconnect);
+  stats_.starttransfer += std::chrono::microseconds(starttransfer);
+  stats_.total += std::chrono::microseconds(total);
+
+  char* url = nullptr;
+  curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url);
+
+  // Structured trace event per transfer, at debug priority so it only lands
+  // in the journal when tracing is actually wanted.
+  sd_journal_send("MESSAGE=transfer complete: %s", url ? url : "",
+                  "PRIORITY=7", "AURACLE_STATUS=%ld", response_code,
+                  "AURACLE_BYTES=%lld", static_cast<long long>(size),
+                  "AURACLE_NAMELOOKUP_USEC=%lld",
+                  static_cast<long long>(namelookup),
+                  "AURACLE_CONNECT_USEC=%lld", static_cast<long long>(connect),
+                  "AURACLE_APPCONNECT_USEC=%lld",
+                  static_cast<long long>(appconnect),
+                  "AURACLE_STARTTRANSFER_USEC=%lld",
+                  static_cast<long long>(starttransfer),
+                  "AURACLE_TOTAL_USEC=%lld", static_cast<long long>(total),
+                  nullptr);
+}
+
 int AurImpl::FinishRequest(sd_event_source* source) {
   active_requests_.erase(source);
   sd_event_source_unref(source);
@@ -452,16 +923,21 @@ int AurImpl::FinishRequest(sd_event_source* source) {
 
 int AurImpl::CheckFinished() {
   int unused;
+  int r = 0;
 
-  auto* msg = curl_multi_info_read(curl_multi_, &unused);
-  if (msg == nullptr || msg->msg != CURLMSG_DONE) {
-    return 0;
-  }
+  // Drain all pending completions. A single event loop wakeup can retire
+  // more than one transfer, and nothing else will notify us about the rest.
+  while (auto* msg = curl_multi_info_read(curl_multi_, &unused)) {
+    if (msg->msg != CURLMSG_DONE) {
+      continue;
+    }
 
-  auto r = FinishRequest(msg->easy_handle, msg->data.result,
-                         /* dispatch_callback = */ true);
-  if (r < 0) {
-    CancelAll();
+    r = FinishRequest(msg->easy_handle, msg->data.result,
+                      /* dispatch_callback = */ true);
+    if (r < 0) {
+      CancelAll();
+      break;
+    }
   }
 
   return r;
@@ -470,8 +946,10 @@ int AurImpl::CheckFinished() {
 int AurImpl::Wait() {
   cancelled_ = false;
 
-  while (!active_requests_.empty()) {
-    if (sd_event_run(event_, 1) < 0) {
+  while (!active_requests_.empty() || pending_parses_ > 0) {
+    // Block until something actually happens. curl drives its own timeouts
+    // through the timer event source, so there's nothing to poll for here.
+    if (sd_event_run(event_, UINT64_MAX) < 0) {
       return -EIO;
     }
   }
@@ -479,48 +957,176 @@ int AurImpl::Wait() {
   return cancelled_ ? -ECANCELED : 0;
 }
 
+void AurImpl::StartHttpRequest(const std::string& url,
+                               ResponseHandler* handler,
+                               const std::string& post_payload) {
+  auto* curl = curl_easy_init();
+  handler->curl = curl;
+
+  using RH = ResponseHandler;
+  curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2);
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &RH::BodyCallback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, handler);
+  curl_easy_setopt(curl, CURLOPT_PRIVATE, handler);
+  curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, handler->error_buffer.data());
+  curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+
+  // Treat a transfer making no progress for 30 seconds as failed. curl
+  // enforces this through the event loop's timer, so stalled transfers are
+  // detected without any polling on our side.
+  curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+  curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 30L);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, options_.useragent.c_str());
+
+  if (!post_payload.empty()) {
+    // COPYPOSTFIELDS copies the payload into the handle, so it doesn't need
+    // to outlive this call.
+    curl_easy_setopt(curl, CURLOPT_COPYPOSTFIELDS, post_payload.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, post_headers_);
+  }
+
+  // TLS sessions, DNS lookups and connections are shared across all easy
+  // handles, so only the first transfer in a burst pays the full setup cost.
+  curl_easy_setopt(curl, CURLOPT_SHARE, curl_share_);
+
+#if LIBCURL_VERSION_NUM >= 0x074001 /* 7.64.1 */
+  if (!options_.session_cachedir.empty()) {
+    const auto altsvc = options_.session_cachedir + "/altsvc.cache";
+    curl_easy_setopt(curl, CURLOPT_ALTSVC, altsvc.c_str());
+    curl_easy_setopt(curl, CURLOPT_ALTSVC_CTRL,
+                     static_cast<long>(CURLALTSVC_H1 | CURLALTSVC_H2));
+  }
+#endif
+
+  switch (debug_level_) {
+    case DebugLevel::NONE:
+      break;
+    case DebugLevel::REQUESTS:
+      curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, &RH::DebugCallback);
+      curl_easy_setopt(curl, CURLOPT_DEBUGDATA, &debug_stream_);
+      [[fallthrough]];
+    case DebugLevel::VERBOSE_STDERR:
+      curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+      break;
+  }
+
+  curl_multi_add_handle(curl_multi_, curl);
+  active_requests_.emplace(curl);
+}
+
 template <typename ResponseHandlerType>
 void AurImpl::QueueHttpRequest(
     const HttpRequest& request,
     const typename ResponseHandlerType::CallbackType& callback) {
   for (const auto& r : request.Build(options_.baseurl)) {
-    auto* curl = curl_easy_init();
-    auto* handler = new ResponseHandlerType(this, callback);
-
-    using RH = ResponseHandler;
-    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2);
-    curl_easy_setopt(curl, CURLOPT_URL, r.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &RH::BodyCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, handler);
-    curl_easy_setopt(curl, CURLOPT_PRIVATE, handler);
-    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, handler->error_buffer.data());
-    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, options_.useragent.c_str());
-
-    switch (debug_level_) {
-      case DebugLevel::NONE:
-        break;
-      case DebugLevel::REQUESTS:
-        curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, &RH::DebugCallback);
-        curl_easy_setopt(curl, CURLOPT_DEBUGDATA, &debug_stream_);
-        [[fallthrough]];
-      case DebugLevel::VERBOSE_STDERR:
-        curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
-        break;
+    StartHttpRequest(r, new ResponseHandlerType(this, callback));
+  }
+}
+
+// static
+int AurImpl::OnCachedResponse(sd_event_source* s, void* userdata) {
+  auto* dispatch = static_cast<CachedRpcDispatch*>(userdata);
+  auto* aur = dispatch->aur;
+
+  aur->FinishRequest(s);
+
+  const int r = dispatch->callback(
+      ResponseWrapper(RpcResponse(dispatch->entry.body()), 200, std::string()));
+  delete dispatch;
+
+  if (r < 0) {
+    aur->CancelAll();
+  }
+
+  return r;
+}
+
+bool AurImpl::EnsureParsePool() {
+  if (parse_pool_) {
+    return true;
+  }
+
+  parse_done_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (parse_done_fd_ < 0) {
+    return false;
+  }
+
+  if (sd_event_add_io(event_, &parse_done_source_, parse_done_fd_, EPOLLIN,
+                      &AurImpl::OnParseDone, this) < 0) {
+    close(parse_done_fd_);
+    parse_done_fd_ = -1;
+    return false;
+  }
+
+  parse_pool_ = std::make_unique<RpcParseWorkerPool>(parse_done_fd_);
+  return true;
+}
+
+void AurImpl::SubmitParse(RpcResponseHandler* handler, std::string body,
+                          long status, std::string error) {
+  ++pending_parses_;
+  parse_pool_->Submit(handler, std::move(body), handler->num_callbacks(),
+                      status, std::move(error));
+}
+
+// static
+int AurImpl::OnParseDone(sd_event_source*, int fd, uint32_t, void* userdata) {
+  auto* aur = static_cast<AurImpl*>(userdata);
+
+  uint64_t count;
+  while (read(fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+  }
+
+  int r = 0;
+  for (auto& result : aur->parse_pool_->TakeResults()) {
+    --aur->pending_parses_;
+
+    // Results arriving after a callback has cancelled everything are
+    // dropped, matching what CancelAll does to unfinished transfers.
+    if (aur->cancelled_) {
+      delete result.handler;
+      continue;
     }
 
-    curl_multi_add_handle(curl_multi_, curl);
-    active_requests_.emplace(curl);
+    const int cr = result.handler->DispatchParsed(std::move(result.responses),
+                                                  result.status, result.error);
+    if (cr < 0) {
+      aur->CancelAll();
+      r = cr;
+    }
   }
+
+  return r;
+}
+
+void AurImpl::QueueCachedRpcResponse(ResponseCache::Entry entry,
+                                     const RpcResponseCallback& callback) {
+  auto* dispatch = new CachedRpcDispatch{this, callback, std::move(entry)};
+
+  // Dispatch from the event loop rather than inline so that queueing a request
+  // never invokes its callback before the caller regains control.
+  sd_event_source* source;
+  if (sd_event_add_defer(event_, &source, &AurImpl::OnCachedResponse,
+                         dispatch) < 0) {
+    dispatch->callback(
+        ResponseWrapper(RpcResponse(dispatch->entry.body()), 200, ""));
+    delete dispatch;
+    return;
+  }
+
+  active_requests_.emplace(source);
 }
 
 // static
 int AurImpl::OnCloneExit(sd_event_source* source, const siginfo_t* si,
                          void* userdata) {
   auto* handler = static_cast<CloneResponseHandler*>(userdata);
+  auto* aur = handler->aur();
 
-  handler->aur()->FinishRequest(source);
+  aur->FinishRequest(source);
+  --aur->active_git_jobs_;
 
   std::string error;
   if (si->si_status != 0) {
@@ -528,25 +1134,78 @@ int AurImpl::OnCloneExit(sd_event_source* source, const siginfo_t* si,
                  std::to_string(si->si_status));
   }
 
-  return handler->RunCallback(si->si_status, error);
+  const int r = handler->RunCallback(si->si_status, error);
+  if (r >= 0) {
+    aur->MaybeStartNextGitJob();
+  }
+
+  return r;
+}
+
+void AurImpl::MaybeStartNextGitJob() {
+  if (queued_git_jobs_.empty()) {
+    return;
+  }
+
+  auto job = std::move(queued_git_jobs_.front());
+  queued_git_jobs_.pop_front();
+
+  job();
 }
 
 void AurImpl::QueueCloneRequest(const CloneRequest& request,
                                 const CloneResponseCallback& callback) {
-  const bool update = fs::exists(fs::path(request.reponame()) / ".git");
+  if (options_.max_clone_jobs > 0 &&
+      active_git_jobs_ >= options_.max_clone_jobs) {
+    queued_git_jobs_.emplace_back(
+        [this, reponame = request.reponame(), callback] {
+          StartCloneRequest(reponame, callback);
+        });
+    return;
+  }
+
+  StartCloneRequest(request.reponame(), callback);
+}
+
+void AurImpl::QueueLsRemoteRequest(const LsRemoteRequest& request,
+                                   const LsRemoteResponseCallback& callback) {
+  if (options_.max_clone_jobs > 0 &&
+      active_git_jobs_ >= options_.max_clone_jobs) {
+    queued_git_jobs_.emplace_back(
+        [this, reponame = request.reponame(), callback] {
+          StartLsRemoteRequest(reponame, callback);
+        });
+    return;
+  }
+
+  StartLsRemoteRequest(request.reponame(), callback);
+}
+
+void AurImpl::StartCloneRequest(const std::string& reponame,
+                                const CloneResponseCallback& callback) {
+  const bool update = fs::exists(fs::path(reponame) / ".git");
 
   auto* handler =
       new CloneResponseHandler(this, callback, update ? "update" : "clone");
 
   int pid = fork();
   if (pid < 0) {
-    handler->RunCallback(-errno, "failed to fork new process for git: " +
-                                     std::string(strerror(errno)));
+    const int r =
+        handler->RunCallback(-errno, "failed to fork new process for git: " +
+                                         std::string(strerror(errno)));
+    // Queued jobs are normally dispatched as running ones exit. A job that
+    // never started has no exit, so keep the chain moving from here --
+    // especially since fork is most likely to fail (EAGAIN) exactly when
+    // many git children are already in flight.
+    if (r >= 0) {
+      MaybeStartNextGitJob();
+    }
     return;
   }
 
   if (pid == 0) {
-    const auto url = request.Build(options_.baseurl)[0];
+    const auto url = CloneRequest(reponame).Build(options_.baseurl)[0];
+    const auto depth = std::to_string(options_.clone_depth);
 
     std::vector<const char*> cmd;
     if (update) {
@@ -554,7 +1213,7 @@ void AurImpl::QueueCloneRequest(const CloneRequest& request,
       cmd = {
         "git",
          "-C",
-        request.reponame().c_str(),
+        reponame.c_str(),
         "pull",
          "--quiet",
          "--rebase",
@@ -568,9 +1227,20 @@ void AurImpl::QueueCloneRequest(const CloneRequest& request,
         "git",
         "clone",
         "--quiet",
-        url.c_str(),
       };
       // clang-format on
+
+      if (options_.clone_depth > 0) {
+        cmd.push_back("--depth");
+        cmd.push_back(depth.c_str());
+      }
+
+      if (!options_.clone_reference.empty()) {
+        cmd.push_back("--reference-if-able");
+        cmd.push_back(options_.clone_reference.c_str());
+      }
+
+      cmd.push_back(url.c_str());
     }
     cmd.push_back(nullptr);
 
@@ -583,6 +1253,104 @@ void AurImpl::QueueCloneRequest(const CloneRequest& request,
                      handler);
 
   active_requests_.emplace(child);
+  ++active_git_jobs_;
+}
+
+// static
+int AurImpl::OnLsRemoteExit(sd_event_source* source, const siginfo_t* si,
+                            void* userdata) {
+  auto* handler = static_cast<LsRemoteResponseHandler*>(userdata);
+  auto* aur = handler->aur();
+
+  aur->FinishRequest(source);
+  --aur->active_git_jobs_;
+
+  // The output is at most one ref line and fits comfortably in the pipe
+  // buffer, so it can be drained in full now that git has exited.
+  char buf[512];
+  for (;;) {
+    const ssize_t n = read(handler->pipe_fd, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+    handler->body.append(buf, n);
+  }
+
+  std::string error;
+  if (si->si_status != 0) {
+    error.assign("git exited with unexpected exit status " +
+                 std::to_string(si->si_status));
+  }
+
+  const int r = handler->RunCallback(si->si_status, error);
+  if (r >= 0) {
+    aur->MaybeStartNextGitJob();
+  }
+
+  return r;
+}
+
+void AurImpl::StartLsRemoteRequest(const std::string& reponame,
+                                   const LsRemoteResponseCallback& callback) {
+  auto* handler = new LsRemoteResponseHandler(this, callback);
+
+  int pipefd[2];
+  if (pipe2(pipefd, O_CLOEXEC) < 0) {
+    // As in StartCloneRequest, a job that never started has no exit to
+    // dispatch the next queued one from, so chain it here.
+    const int r =
+        handler->RunCallback(-errno, "failed to create pipe for git: " +
+                                         std::string(strerror(errno)));
+    if (r >= 0) {
+      MaybeStartNextGitJob();
+    }
+    return;
+  }
+
+  int pid = fork();
+  if (pid < 0) {
+    close(pipefd[0]);
+    close(pipefd[1]);
+    const int r =
+        handler->RunCallback(-errno, "failed to fork new process for git: " +
+                                         std::string(strerror(errno)));
+    if (r >= 0) {
+      MaybeStartNextGitJob();
+    }
+    return;
+  }
+
+  if (pid == 0) {
+    const auto url = LsRemoteRequest(reponame).Build(options_.baseurl)[0];
+
+    dup2(pipefd[1], STDOUT_FILENO);
+
+    // clang-format off
+    const char* cmd[] = {
+      "git",
+      "ls-remote",
+      url.c_str(),
+      "HEAD",
+      nullptr,
+    };
+    // clang-format on
+
+    execvp(cmd[0], const_cast<char* const*>(cmd));
+    _exit(127);
+  }
+
+  close(pipefd[1]);
+  handler->pipe_fd = pipefd[0];
+
+  sd_event_source* child;
+  sd_event_add_child(event_, &child, pid, WEXITED, &AurImpl::OnLsRemoteExit,
+                     handler);
+
+  active_requests_.emplace(child);
+  ++active_git_jobs_;
 }
 
 void AurImpl::QueueRawRequest(const HttpRequest& request,
@@ -590,9 +1358,79 @@ void AurImpl::QueueRawRequest(const HttpRequest& request,
   QueueHttpRequest<RawResponseHandler>(request, callback);
 }
 
-void AurImpl::QueueRpcRequest(const RpcRequest& request,
-                              const RpcResponseCallback& callback) {
-  QueueHttpRequest<RpcResponseHandler>(request, callback);
+void AurImpl::QueueStreamingRawRequest(const HttpRequest& request,
+                                       const RawChunkSink& sink,
+                                       const RawResponseCallback& callback) {
+  for (const auto& r : request.Build(options_.baseurl)) {
+    StartHttpRequest(r, new StreamingRawResponseHandler(this, callback, sink));
+  }
+}
+
+int AurImpl::QueueRpcRequest(const RpcRequest& request,
+                             const RpcResponseCallback& callback) {
+  if (options_.use_rpc_post) {
+    const auto payload = request.Payload();
+    if (payload.empty()) {
+      return 0;
+    }
+
+    // POSTing the arguments as the request body sidesteps the URI length
+    // limit, so a bulk info query that Build() would chop into several GETs
+    // is a single round trip. The cache and coalescing key folds the payload
+    // back into the URL, which makes it identical to the GET URL for any
+    // request small enough to have fit in one.
+    const auto url = request.Url(options_.baseurl);
+    const auto key = url + "&" + payload;
+
+    if (cache_) {
+      auto entry = cache_->Get(key);
+      if (entry.has_value()) {
+        QueueCachedRpcResponse(std::move(*entry), callback);
+        return 1;
+      }
+    }
+
+    const auto iter = in_flight_rpcs_.find(key);
+    if (iter != in_flight_rpcs_.end()) {
+      iter->second->AddCallback(callback);
+      return 1;
+    }
+
+    auto* handler = new RpcResponseHandler(
+        this, callback, cache_ ? &*cache_ : nullptr, key, &in_flight_rpcs_);
+    in_flight_rpcs_.emplace(key, handler);
+    StartHttpRequest(url, handler, payload);
+    return 1;
+  }
+
+  int queued = 0;
+  for (const auto& r : request.Build(options_.baseurl)) {
+    ++queued;
+
+    if (cache_) {
+      auto entry = cache_->Get(r);
+      if (entry.has_value()) {
+        QueueCachedRpcResponse(std::move(*entry), callback);
+        continue;
+      }
+    }
+
+    // Coalesce identical in-flight requests: recursive dependency resolution
+    // routinely asks for the same package from several dependency lists. Fan
+    // the single response out to every interested callback instead.
+    const auto iter = in_flight_rpcs_.find(r);
+    if (iter != in_flight_rpcs_.end()) {
+      iter->second->AddCallback(callback);
+      continue;
+    }
+
+    auto* handler = new RpcResponseHandler(
+        this, callback, cache_ ? &*cache_ : nullptr, r, &in_flight_rpcs_);
+    in_flight_rpcs_.emplace(r, handler);
+    StartHttpRequest(r, handler);
+  }
+
+  return queued;
 }
 
 std::unique_ptr<Aur> NewAur(Aur::Options options) {
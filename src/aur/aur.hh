@@ -1,9 +1,11 @@
 #ifndef AUR_AUR_HH_
 #define AUR_AUR_HH_
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "request.hh"
 #include "response.hh"
@@ -18,6 +20,10 @@ class Aur {
   using RpcResponseCallback = ResponseCallback<RpcResponse>;
   using RawResponseCallback = ResponseCallback<RawResponse>;
   using CloneResponseCallback = ResponseCallback<CloneResponse>;
+  using LsRemoteResponseCallback = ResponseCallback<LsRemoteResponse>;
+
+  // Receives body chunks of a streaming raw request as they arrive.
+  using RawChunkSink = std::function<void(std::string_view chunk)>;
 
   struct Options {
     Options() = default;
@@ -39,6 +45,91 @@ class Aur {
       return *this;
     }
     std::string useragent;
+
+    // Enables a persistent on-disk cache of RPC responses when non-empty.
+    Options& set_cachedir(std::string cachedir) {
+      this->cachedir = std::move(cachedir);
+      return *this;
+    }
+    std::string cachedir;
+
+    Options& set_cache_ttl(std::chrono::seconds cache_ttl) {
+      this->cache_ttl = cache_ttl;
+      return *this;
+    }
+    std::chrono::seconds cache_ttl = std::chrono::minutes(5);
+
+    // Sends RPC requests as POSTs with the argument list in the request
+    // body, so bulk info queries that would otherwise be split across
+    // several URI-length-limited GETs complete in a single round trip. Set
+    // to false to fall back to GET against servers that don't accept POST
+    // on the RPC endpoint.
+    Options& set_use_rpc_post(bool use_rpc_post) {
+      this->use_rpc_post = use_rpc_post;
+      return *this;
+    }
+    bool use_rpc_post = true;
+
+    // Persists negotiated session state (currently the alt-svc cache, which
+    // remembers HTTP version upgrades) in the given directory between runs
+    // when non-empty. TLS session tickets are held by libcurl in memory
+    // only, so they are shared across connections within a run but cannot
+    // outlive the process.
+    Options& set_session_cachedir(std::string session_cachedir) {
+      this->session_cachedir = std::move(session_cachedir);
+      return *this;
+    }
+    std::string session_cachedir;
+
+    // Caps the connection pool across all hosts. Zero picks a default based
+    // on the base URL: 5 against the public AUR (which rate limits), wider
+    // against anything else, e.g. a local mirror.
+    Options& set_max_total_connections(int max_total_connections) {
+      this->max_total_connections = max_total_connections;
+      return *this;
+    }
+    int max_total_connections = 0;
+
+    // Caps connections to a single host. Zero leaves curl's default (no
+    // limit beyond the total) in place.
+    Options& set_max_host_connections(int max_host_connections) {
+      this->max_host_connections = max_host_connections;
+      return *this;
+    }
+    int max_host_connections = 0;
+
+    // Caps concurrent HTTP/2 streams per connection. Zero leaves curl's
+    // default in place.
+    Options& set_max_concurrent_streams(int max_concurrent_streams) {
+      this->max_concurrent_streams = max_concurrent_streams;
+      return *this;
+    }
+    int max_concurrent_streams = 0;
+
+    // Maximum number of git processes to run concurrently for clone and
+    // ls-remote requests. Zero means no limit.
+    Options& set_max_clone_jobs(int max_clone_jobs) {
+      this->max_clone_jobs = max_clone_jobs;
+      return *this;
+    }
+    int max_clone_jobs = 5;
+
+    // Truncate history to the given number of commits when cloning
+    // (git clone --depth). Zero clones the full history.
+    Options& set_clone_depth(int clone_depth) {
+      this->clone_depth = clone_depth;
+      return *this;
+    }
+    int clone_depth = 0;
+
+    // Borrow objects from a shared local repository when cloning
+    // (git clone --reference-if-able). Repositories that don't exist or
+    // aren't usable are silently ignored by git.
+    Options& set_clone_reference(std::string clone_reference) {
+      this->clone_reference = std::move(clone_reference);
+      return *this;
+    }
+    std::string clone_reference;
   };
 
   Aur() = default;
@@ -50,27 +141,65 @@ class Aur {
   Aur(Aur&&) = default;
   Aur& operator=(Aur&&) = default;
 
-  // Asynchronously issue an RPC request. The callback will be invoked when the
-  // call completes.
-  virtual void QueueRpcRequest(const RpcRequest& request,
-                               const RpcResponseCallback& callback) = 0;
+  // Asynchronously issue an RPC request. The callback will be invoked when
+  // the call completes. Returns the number of underlying requests issued --
+  // with use_rpc_post disabled, an oversized request splits across several
+  // transfers -- which is the number of times the callback will be invoked.
+  virtual int QueueRpcRequest(const RpcRequest& request,
+                              const RpcResponseCallback& callback) = 0;
 
   // Asynchronously issue a raw request. The callback will be invoked when the
   // call completes.
   virtual void QueueRawRequest(const HttpRequest& request,
                                const RawResponseCallback& callback) = 0;
 
+  // Like QueueRawRequest, but hands body chunks to the sink as they arrive
+  // instead of buffering them. Only successful (HTTP 200) responses are
+  // streamed; the final callback then sees a response with empty bytes. On
+  // any other status the body is buffered as usual so the callback can
+  // inspect it.
+  virtual void QueueStreamingRawRequest(const HttpRequest& request,
+                                        const RawChunkSink& sink,
+                                        const RawResponseCallback& callback) = 0;
+
   // Clone a git repository.
   virtual void QueueCloneRequest(const CloneRequest& request,
                                  const CloneResponseCallback& callback) = 0;
 
+  // Probe the remote HEAD of a git repository via `git ls-remote`, without
+  // touching any local clone. Probes share the clone parallelism limit.
+  virtual void QueueLsRemoteRequest(
+      const LsRemoteRequest& request,
+      const LsRemoteResponseCallback& callback) = 0;
+
   // Wait for all pending requests to complete. Returns non-zero if any request
   // failed or was cancelled by a callback.
   virtual int Wait() = 0;
+
+  // Transfer timing aggregated over the lifetime of this object, harvested
+  // from curl as each transfer completes. Durations are sums across
+  // transfers; appconnect covers the TLS handshake and starttransfer is
+  // time to first body byte.
+  struct Stats {
+    int requests = 0;
+    long bytes_received = 0;
+    std::chrono::microseconds namelookup{};
+    std::chrono::microseconds connect{};
+    std::chrono::microseconds appconnect{};
+    std::chrono::microseconds starttransfer{};
+    std::chrono::microseconds total{};
+  };
+
+  virtual Stats stats() const = 0;
 };
 
 std::unique_ptr<Aur> NewAur(Aur::Options options = Aur::Options());
 
+// Returns an Aur which answers RPC requests from a local copy of the AUR's
+// metadata dump (a decompressed packages-meta-ext-v1.json) rather than the
+// network. Raw and clone requests fail with an error in this mode.
+std::unique_ptr<Aur> NewLocalAur(std::string dump_path);
+
 }  // namespace aur
 
 #endif  // AUR_AUR_HH_
@@ -0,0 +1,99 @@
+#ifndef AUR_CORO_HH_
+#define AUR_CORO_HH_
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "aur.hh"
+
+namespace aur {
+
+// A detached, eagerly-started coroutine. The body runs synchronously until
+// its first co_await, queueing work against the Aur it was given; the event
+// loop inside Aur::Wait resumes it as responses arrive. The frame destroys
+// itself when the body finishes, so completion is tracked the same way as
+// with plain callbacks: Wait returns once nothing is left in flight.
+class Task {
+ public:
+  struct promise_type {
+    Task get_return_object() { return Task(); }
+    std::suspend_never initial_suspend() { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+// Awaitable produced by the Await* adapters below. The request is queued on
+// suspension and the co_await expression yields the ResponseWrapper that the
+// callback API would have been handed.
+template <typename ResponseT>
+class [[nodiscard]] RequestAwaitable {
+ public:
+  using QueueFn = std::function<void(const Aur::ResponseCallback<ResponseT>&)>;
+
+  explicit RequestAwaitable(QueueFn queue) : queue_(std::move(queue)) {}
+
+  RequestAwaitable(const RequestAwaitable&) = delete;
+  RequestAwaitable& operator=(const RequestAwaitable&) = delete;
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    queue_([this, handle](ResponseWrapper<ResponseT> response) {
+      result_.emplace(std::move(response));
+      handle.resume();
+      // Cancellation doesn't flow back out of a coroutine; one that wants to
+      // stop simply stops queueing further requests.
+      return 0;
+    });
+  }
+
+  ResponseWrapper<ResponseT> await_resume() { return std::move(*result_); }
+
+ private:
+  QueueFn queue_;
+  std::optional<ResponseWrapper<ResponseT>> result_;
+};
+
+// Adapters over the callback API, for use in a Task:
+//
+//   aur::Task Dump(aur::Aur& aur, const std::vector<std::string>& args) {
+//     auto response = co_await aur::AwaitRpcRequest(aur, aur::InfoRequest(args));
+//     ...
+//   }
+//
+// The request is consumed before the first suspension, so passing a temporary
+// is fine. Each adapter assumes the request completes with a single response;
+// with Options::use_rpc_post disabled an oversized info request is split
+// across several transfers and must use QueueRpcRequest directly.
+inline RequestAwaitable<RpcResponse> AwaitRpcRequest(
+    Aur& aur, const RpcRequest& request) {
+  return RequestAwaitable<RpcResponse>(
+      [&](const Aur::RpcResponseCallback& callback) {
+        aur.QueueRpcRequest(request, callback);
+      });
+}
+
+inline RequestAwaitable<RawResponse> AwaitRawRequest(
+    Aur& aur, const HttpRequest& request) {
+  return RequestAwaitable<RawResponse>(
+      [&](const Aur::RawResponseCallback& callback) {
+        aur.QueueRawRequest(request, callback);
+      });
+}
+
+inline RequestAwaitable<CloneResponse> AwaitCloneRequest(
+    Aur& aur, const CloneRequest& request) {
+  return RequestAwaitable<CloneResponse>(
+      [&](const Aur::CloneResponseCallback& callback) {
+        aur.QueueCloneRequest(request, callback);
+      });
+}
+
+}  // namespace aur
+
+#endif  // AUR_CORO_HH_
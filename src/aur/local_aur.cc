@@ -0,0 +1,274 @@
+#include <curl/curl.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+#include "aur.hh"
+
+namespace aur {
+
+namespace {
+
+std::string UrlUnescape(std::string_view sv) {
+  int outlen;
+  char* ptr = curl_easy_unescape(nullptr, sv.data(), sv.size(), &outlen);
+  std::string unescaped(ptr, outlen);
+  curl_free(ptr);
+
+  return unescaped;
+}
+
+// The query parameters of an RPC request URL, recovered from the URL that
+// would have been sent to the AUR.
+struct ParsedRpcRequest {
+  std::string type;
+  std::string by = "name-desc";
+  std::vector<std::string> args;
+};
+
+ParsedRpcRequest ParseRpcUrl(std::string_view url) {
+  ParsedRpcRequest parsed;
+
+  const auto query_start = url.find('?');
+  if (query_start == std::string_view::npos) {
+    return parsed;
+  }
+
+  auto query = url.substr(query_start + 1);
+  while (!query.empty()) {
+    const auto param = query.substr(0, query.find('&'));
+    query.remove_prefix(std::min(query.size(), param.size() + 1));
+
+    const auto equals = param.find('=');
+    if (equals == std::string_view::npos) {
+      continue;
+    }
+
+    const auto key = param.substr(0, equals);
+    auto value = UrlUnescape(param.substr(equals + 1));
+
+    if (key == "type") {
+      parsed.type = std::move(value);
+    } else if (key == "by") {
+      parsed.by = std::move(value);
+    } else if (key == "arg" || key == "arg[]") {
+      parsed.args.push_back(std::move(value));
+    }
+  }
+
+  return parsed;
+}
+
+bool ContainsCaseInsensitive(std::string_view haystack,
+                             std::string_view needle) {
+  const auto iter = std::search(
+      haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+      [](char a, char b) { return tolower(a) == tolower(b); });
+  return iter != haystack.end();
+}
+
+bool DependsOn(const std::vector<Dependency>& deps, std::string_view arg) {
+  return std::any_of(deps.begin(), deps.end(),
+                     [&](const Dependency& dep) { return dep.name() == arg; });
+}
+
+// An Aur implementation which answers RPC requests from a local copy of the
+// AUR's metadata dump (packages-meta-ext-v1.json, decompressed) instead of
+// the network. The dump is memory mapped and deserialized once, on first use.
+class LocalAur : public Aur {
+ public:
+  explicit LocalAur(std::string dump_path) : dump_path_(std::move(dump_path)) {}
+
+  int QueueRpcRequest(const RpcRequest& request,
+                      const RpcResponseCallback& callback) override {
+    int queued = 0;
+    for (const auto& url : request.Build("")) {
+      ++queued;
+      pending_.push_back([this, url, callback] {
+        if (!EnsureLoaded()) {
+          return callback(ResponseWrapper(RpcResponse(), 0, load_error_));
+        }
+
+        return callback(
+            ResponseWrapper(HandleRpc(ParseRpcUrl(url)), 200, std::string()));
+      });
+    }
+
+    return queued;
+  }
+
+  void QueueRawRequest(const HttpRequest&,
+                       const RawResponseCallback& callback) override {
+    pending_.push_back([callback] {
+      return callback(ResponseWrapper(
+          RawResponse(""), 0, "raw requests are not answerable offline"));
+    });
+  }
+
+  void QueueStreamingRawRequest(const HttpRequest&, const RawChunkSink&,
+                                const RawResponseCallback& callback) override {
+    pending_.push_back([callback] {
+      return callback(ResponseWrapper(
+          RawResponse(""), 0, "raw requests are not answerable offline"));
+    });
+  }
+
+  void QueueCloneRequest(const CloneRequest&,
+                         const CloneResponseCallback& callback) override {
+    pending_.push_back([callback] {
+      return callback(ResponseWrapper(
+          CloneResponse(""), 0, "clone requests are not answerable offline"));
+    });
+  }
+
+  void QueueLsRemoteRequest(const LsRemoteRequest&,
+                            const LsRemoteResponseCallback& callback) override {
+    pending_.push_back([callback] {
+      return callback(ResponseWrapper(
+          LsRemoteResponse(""), 0,
+          "ls-remote requests are not answerable offline"));
+    });
+  }
+
+  int Wait() override {
+    while (!pending_.empty()) {
+      auto callback = std::move(pending_.front());
+      pending_.pop_front();
+
+      if (callback() < 0) {
+        pending_.clear();
+        return -ECANCELED;
+      }
+    }
+
+    return 0;
+  }
+
+  // No transfers happen offline, so there's nothing to report.
+  Stats stats() const override { return {}; }
+
+ private:
+  bool EnsureLoaded();
+  RpcResponse HandleRpc(const ParsedRpcRequest& request) const;
+
+  std::string dump_path_;
+
+  bool loaded_ = false;
+  std::string load_error_;
+  std::vector<Package> packages_;
+  std::unordered_map<std::string, size_t> index_by_pkgname_;
+
+  std::deque<std::function<int()>> pending_;
+};
+
+bool LocalAur::EnsureLoaded() {
+  if (loaded_) {
+    return load_error_.empty();
+  }
+  loaded_ = true;
+
+  const int fd = open(dump_path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    load_error_ = dump_path_ + ": " + strerror(errno);
+    return false;
+  }
+
+  struct stat st{};
+  fstat(fd, &st);
+
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    load_error_ = dump_path_ + ": " + strerror(errno);
+    return false;
+  }
+
+  const std::string_view contents(static_cast<const char*>(addr), st.st_size);
+
+  // The dump is a bare array of package objects, which RpcResponse's parser
+  // accepts directly.
+  RpcResponse parsed(contents);
+  munmap(addr, st.st_size);
+
+  if (!parsed.error.empty()) {
+    load_error_ = dump_path_ + ": " + parsed.error;
+    return false;
+  }
+  packages_ = std::move(parsed.results);
+
+  index_by_pkgname_.reserve(packages_.size());
+  for (size_t i = 0; i < packages_.size(); ++i) {
+    index_by_pkgname_.emplace(packages_[i].name, i);
+  }
+
+  return true;
+}
+
+RpcResponse LocalAur::HandleRpc(const ParsedRpcRequest& request) const {
+  RpcResponse response;
+  response.version = 5;
+
+  if (request.type == "info") {
+    response.type = "multiinfo";
+
+    for (const auto& arg : request.args) {
+      const auto iter = index_by_pkgname_.find(arg);
+      if (iter != index_by_pkgname_.end()) {
+        response.results.push_back(packages_[iter->second]);
+      }
+    }
+  } else if (request.type == "search" && !request.args.empty()) {
+    response.type = "search";
+
+    const auto& arg = request.args[0];
+    const auto matches = [&](const Package& p) {
+      if (request.by == "name") {
+        return ContainsCaseInsensitive(p.name, arg);
+      } else if (request.by == "name-desc") {
+        return ContainsCaseInsensitive(p.name, arg) ||
+               ContainsCaseInsensitive(p.description, arg);
+      } else if (request.by == "maintainer") {
+        return p.maintainer == arg;
+      } else if (request.by == "depends") {
+        return DependsOn(p.depends, arg);
+      } else if (request.by == "makedepends") {
+        return DependsOn(p.makedepends, arg);
+      } else if (request.by == "checkdepends") {
+        return DependsOn(p.checkdepends, arg);
+      } else if (request.by == "optdepends") {
+        return std::any_of(p.optdepends.begin(), p.optdepends.end(),
+                           [&](const std::string& optdep) {
+                             return optdep.substr(0, optdep.find(':')) == arg;
+                           });
+      }
+      return false;
+    };
+
+    std::copy_if(packages_.begin(), packages_.end(),
+                 std::back_inserter(response.results), matches);
+  } else {
+    response.type = "error";
+    response.error = "unsupported request type '" + request.type + "'";
+  }
+
+  response.resultcount = response.results.size();
+  return response;
+}
+
+}  // namespace
+
+std::unique_ptr<Aur> NewLocalAur(std::string dump_path) {
+  return std::make_unique<LocalAur>(std::move(dump_path));
+}
+
+}  // namespace aur
+
+/* vim: set et ts=2 sw=2: */
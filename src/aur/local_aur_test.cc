@@ -0,0 +1,112 @@
+#include <filesystem>
+#include <fstream>
+
+#include "aur.hh"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kDump[] = R"([
+  {
+    "ID": 1,
+    "Name": "auracle-git",
+    "PackageBase": "auracle-git",
+    "PackageBaseID": 1,
+    "Version": "r36.752e4ba-1",
+    "Description": "A flexible client for the AUR",
+    "Depends": [ "pacman", "libcurl.so" ]
+  },
+  {
+    "ID": 2,
+    "Name": "pkgfile-git",
+    "PackageBase": "pkgfile-git",
+    "PackageBaseID": 2,
+    "Version": "22-1",
+    "Description": "a pacman files metadata explorer",
+    "Depends": [ "libarchive", "libcurl.so" ]
+  }
+])";
+
+class LocalAurTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    dump_path_ = fs::temp_directory_path() / "local_aur_test.json";
+
+    std::ofstream file(dump_path_, std::ofstream::trunc);
+    file << kDump;
+  }
+
+  void TearDown() override { fs::remove(dump_path_); }
+
+  fs::path dump_path_;
+};
+
+TEST_F(LocalAurTest, AnswersInfoRequests) {
+  auto aur = aur::NewLocalAur(dump_path_);
+
+  std::vector<aur::Package> packages;
+  aur->QueueRpcRequest(aur::InfoRequest({"auracle-git", "notfound"}),
+                       [&](aur::ResponseWrapper<aur::RpcResponse> response) {
+                         EXPECT_TRUE(response.ok());
+                         packages = response.value().results;
+                         return 0;
+                       });
+
+  ASSERT_EQ(aur->Wait(), 0);
+  ASSERT_EQ(packages.size(), 1);
+  EXPECT_EQ(packages[0].name, "auracle-git");
+  EXPECT_EQ(packages[0].version, "r36.752e4ba-1");
+}
+
+TEST_F(LocalAurTest, AnswersSearchRequests) {
+  auto aur = aur::NewLocalAur(dump_path_);
+
+  std::vector<aur::Package> packages;
+  aur->QueueRpcRequest(
+      aur::SearchRequest(aur::SearchRequest::SearchBy::NAME_DESC, "PACMAN"),
+      [&](aur::ResponseWrapper<aur::RpcResponse> response) {
+        EXPECT_TRUE(response.ok());
+        packages = response.value().results;
+        return 0;
+      });
+
+  ASSERT_EQ(aur->Wait(), 0);
+  ASSERT_EQ(packages.size(), 1);
+  EXPECT_EQ(packages[0].name, "pkgfile-git");
+}
+
+TEST_F(LocalAurTest, AnswersDependsSearchRequests) {
+  auto aur = aur::NewLocalAur(dump_path_);
+
+  std::vector<aur::Package> packages;
+  aur->QueueRpcRequest(
+      aur::SearchRequest(aur::SearchRequest::SearchBy::DEPENDS, "libarchive"),
+      [&](aur::ResponseWrapper<aur::RpcResponse> response) {
+        EXPECT_TRUE(response.ok());
+        packages = response.value().results;
+        return 0;
+      });
+
+  ASSERT_EQ(aur->Wait(), 0);
+  ASSERT_EQ(packages.size(), 1);
+  EXPECT_EQ(packages[0].name, "pkgfile-git");
+}
+
+TEST_F(LocalAurTest, ReportsMissingDump) {
+  auto aur = aur::NewLocalAur("/nonexistent/dump.json");
+
+  std::string error;
+  aur->QueueRpcRequest(aur::InfoRequest({"auracle-git"}),
+                       [&](aur::ResponseWrapper<aur::RpcResponse> response) {
+                         error = response.error();
+                         return 0;
+                       });
+
+  ASSERT_EQ(aur->Wait(), 0);
+  EXPECT_THAT(error, testing::HasSubstr("/nonexistent/dump.json"));
+}
+
+}  // namespace
@@ -3,6 +3,7 @@
 
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace aur {
@@ -17,10 +18,29 @@ struct Dependency {
     LT,
   };
 
+  Dependency() = default;
+
+  // Parses a depstring, e.g. "foo>=1.0", into its name, version and
+  // comparison modifier.
+  explicit Dependency(std::string depstring);
+
+  // The name and version are views into depstring rather than copies --
+  // dependency lists dominate the allocation profile of broad queries, and
+  // this keeps them at one string per depstring. Stored as offsets so that
+  // moving or copying a Dependency can't dangle.
+  std::string_view name() const {
+    return std::string_view(depstring).substr(0, name_len_);
+  }
+  std::string_view version() const {
+    return std::string_view(depstring).substr(version_offset_);
+  }
+
   std::string depstring;
-  std::string name;
-  std::string version;
   Mod mod = Mod::ANY;
+
+ private:
+  std::string::size_type name_len_ = 0;
+  std::string::size_type version_offset_ = 0;
 };
 
 struct Package {
@@ -99,6 +99,14 @@ std::vector<std::string> RpcRequest::Build(std::string_view baseurl) const {
   return requests;
 }
 
+std::string RpcRequest::Url(std::string_view baseurl) const {
+  return StrCat(baseurl, "/rpc?", base_querystring_);
+}
+
+std::string RpcRequest::Payload() const {
+  return StrJoin(args_, "&", &QueryParamFormatter);
+}
+
 RpcRequest::RpcRequest(const HttpRequest::QueryParams& base_params,
                        long unsigned approx_max_length)
     : base_querystring_(StrJoin(base_params, "&", &QueryParamFormatter)),
@@ -119,4 +127,9 @@ std::vector<std::string> CloneRequest::Build(std::string_view baseurl) const {
   return {StrCat(baseurl, "/", reponame_)};
 }
 
+std::vector<std::string> LsRemoteRequest::Build(
+    std::string_view baseurl) const {
+  return {StrCat(baseurl, "/", reponame_)};
+}
+
 }  // namespace aur
@@ -63,6 +63,27 @@ class CloneRequest : public Request {
   std::string reponame_;
 };
 
+// A class describing a git repo hosted on the AUR whose remote HEAD is to
+// be probed with ls-remote.
+class LsRemoteRequest : public Request {
+ public:
+  explicit LsRemoteRequest(std::string reponame)
+      : reponame_(std::move(reponame)) {}
+
+  LsRemoteRequest(const LsRemoteRequest&) = delete;
+  LsRemoteRequest& operator=(const LsRemoteRequest&) = delete;
+
+  LsRemoteRequest(LsRemoteRequest&&) = default;
+  LsRemoteRequest& operator=(LsRemoteRequest&&) = default;
+
+  const std::string& reponame() const { return reponame_; }
+
+  std::vector<std::string> Build(std::string_view baseurl) const override;
+
+ private:
+  std::string reponame_;
+};
+
 // A base class describing a GET request to the RPC endpoint of the AUR.
 class RpcRequest : public HttpRequest {
  public:
@@ -80,6 +101,13 @@ class RpcRequest : public HttpRequest {
 
   std::vector<std::string> Build(std::string_view baseurl) const override;
 
+  // The RPC endpoint URL with only the base parameters, for use together
+  // with Payload() when POSTing the argument list as a request body.
+  std::string Url(std::string_view baseurl) const;
+
+  // The complete argument querystring, unsplit regardless of length.
+  std::string Payload() const;
+
   void AddArg(std::string_view key, std::string_view value);
 
  private:
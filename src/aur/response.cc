@@ -1,34 +1,304 @@
 #include "response.hh"
 
-#include "json_internal.hh"
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+#include "nlohmann/json.hpp"
 
 namespace aur {
 
-void from_json(const nlohmann::json& j, RpcResponse& r) {
-  // clang-format off
-  static const auto& callbacks = *new CallbackMap<RpcResponse>{
-    { "type",         MakeValueCallback(&RpcResponse::type) },
-    { "error",        MakeValueCallback(&RpcResponse::error) },
-    { "resultcount",  MakeValueCallback(&RpcResponse::resultcount) },
-    { "version",      MakeValueCallback(&RpcResponse::version) },
-    { "results",      MakeValueCallback(&RpcResponse::results) },
+namespace {
+
+template <typename T>
+using FieldMap = std::unordered_map<std::string_view, T Package::*>;
+
+// clang-format off
+const auto& kStringFields = *new FieldMap<std::string>{
+  { "Description",    &Package::description },
+  { "Maintainer",     &Package::maintainer },
+  { "Name",           &Package::name },
+  { "PackageBase",    &Package::pkgbase },
+  { "URL",            &Package::upstream_url },
+  { "URLPath",        &Package::aur_urlpath },
+  { "Version",        &Package::version },
+};
+
+const auto& kIntFields = *new FieldMap<int>{
+  { "ID",             &Package::package_id },
+  { "NumVotes",       &Package::votes },
+  { "PackageBaseID",  &Package::pkgbase_id },
+};
+
+const auto& kTimeFields = *new FieldMap<std::chrono::seconds>{
+  { "FirstSubmitted", &Package::submitted },
+  { "LastModified",   &Package::modified },
+  { "OutOfDate",      &Package::out_of_date },
+};
+
+const auto& kStringListFields = *new FieldMap<std::vector<std::string>>{
+  { "Conflicts",      &Package::conflicts },
+  { "Groups",         &Package::groups },
+  { "Keywords",       &Package::keywords },
+  { "License",        &Package::licenses },
+  { "OptDepends",     &Package::optdepends },
+  { "Provides",       &Package::provides },
+  { "Replaces",       &Package::replaces },
+};
+
+const auto& kDependencyListFields = *new FieldMap<std::vector<Dependency>>{
+  { "CheckDepends",   &Package::checkdepends },
+  { "Depends",        &Package::depends },
+  { "MakeDepends",    &Package::makedepends },
+};
+// clang-format on
+
+// A SAX handler which builds an RpcResponse directly from parse events,
+// without materializing an intermediate DOM. Peak memory during parsing is
+// proportional to a single package rather than the whole response body. The
+// handler accepts either an RPC response envelope or a bare array of package
+// objects (the layout of the AUR's metadata dumps).
+class RpcResponseParser {
+ public:
+  explicit RpcResponseParser(RpcResponse* response) : response_(response) {}
+
+  bool null() {
+    // Semantically absent fields (e.g. Maintainer, OutOfDate) arrive as JSON
+    // nulls; leave the default-constructed value in place.
+    return true;
+  }
+
+  bool boolean(bool) { return true; }
+
+  bool number_integer(std::int64_t value) { return Number(value); }
+  bool number_unsigned(std::uint64_t value) { return Number(value); }
+  bool number_float(double value, const std::string&) { return Number(value); }
+
+  template <typename BinaryType>
+  bool binary(BinaryType&) {
+    return true;
+  }
+
+  bool string(std::string& value) {
+    if (skip_depth_ > 0) {
+      return true;
+    }
+
+    switch (state_) {
+      case State::kRoot:
+        if (key_ == "type") {
+          response_->type = std::move(value);
+        } else if (key_ == "error") {
+          response_->error = std::move(value);
+        }
+        break;
+      case State::kPackage:
+        if (const auto iter = kStringFields.find(key_);
+            iter != kStringFields.end()) {
+          response_->results.back().*(iter->second) = std::move(value);
+        }
+        break;
+      case State::kStringList:
+        (response_->results.back().*string_list_).push_back(std::move(value));
+        break;
+      case State::kDependencyList:
+        (response_->results.back().*dependency_list_)
+            .push_back(Dependency(std::move(value)));
+        break;
+      default:
+        break;
+    }
+
+    return true;
+  }
+
+  bool key(std::string& value) {
+    if (skip_depth_ > 0) {
+      return true;
+    }
+
+    key_ = std::move(value);
+    return true;
+  }
+
+  bool start_object(std::size_t) {
+    if (skip_depth_ > 0) {
+      ++skip_depth_;
+      return true;
+    }
+
+    switch (state_) {
+      case State::kStart:
+        state_ = State::kRoot;
+        break;
+      case State::kResults:
+        response_->results.emplace_back();
+        state_ = State::kPackage;
+        break;
+      default:
+        ++skip_depth_;
+        break;
+    }
+
+    return true;
+  }
+
+  bool end_object() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+
+    if (state_ == State::kPackage) {
+      state_ = State::kResults;
+    }
+
+    return true;
+  }
+
+  bool start_array(std::size_t) {
+    if (skip_depth_ > 0) {
+      ++skip_depth_;
+      return true;
+    }
+
+    switch (state_) {
+      case State::kStart:
+        state_ = State::kResults;
+        break;
+      case State::kRoot:
+        if (key_ == "results") {
+          state_ = State::kResults;
+        } else {
+          ++skip_depth_;
+        }
+        break;
+      case State::kPackage:
+        if (const auto iter = kStringListFields.find(key_);
+            iter != kStringListFields.end()) {
+          string_list_ = iter->second;
+          state_ = State::kStringList;
+        } else if (const auto iter = kDependencyListFields.find(key_);
+                   iter != kDependencyListFields.end()) {
+          dependency_list_ = iter->second;
+          state_ = State::kDependencyList;
+        } else {
+          ++skip_depth_;
+        }
+        break;
+      default:
+        ++skip_depth_;
+        break;
+    }
+
+    return true;
+  }
+
+  bool end_array() {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      return true;
+    }
+
+    switch (state_) {
+      case State::kResults:
+        state_ = State::kRoot;
+        break;
+      case State::kStringList:
+      case State::kDependencyList:
+        state_ = State::kPackage;
+        break;
+      default:
+        break;
+    }
+
+    return true;
+  }
+
+  bool parse_error(std::size_t, const std::string&,
+                   const nlohmann::detail::exception& ex) {
+    response_->type = "error";
+    response_->error = ex.what();
+    return false;
+  }
+
+ private:
+  enum class State {
+    kStart,
+    kRoot,
+    kResults,
+    kPackage,
+    kStringList,
+    kDependencyList,
   };
-  // clang-format on
 
-  DeserializeJsonObject(j, callbacks, r);
-}
+  // The AUR caps search results at 5000; don't let a larger claimed
+  // resultcount reserve unbounded memory.
+  static constexpr std::int64_t kMaxReserve = 5000;
+
+  template <typename T>
+  bool Number(T value) {
+    if (skip_depth_ > 0) {
+      return true;
+    }
+
+    switch (state_) {
+      case State::kRoot:
+        if (key_ == "resultcount") {
+          response_->resultcount = value;
+          // The AUR emits resultcount ahead of the results array, so this
+          // sizes the vector once instead of growing it package by package.
+          // Clamp it to defend against a hostile or buggy server.
+          if (value > 0) {
+            response_->results.reserve(
+                std::min<std::int64_t>(value, kMaxReserve));
+          }
+        } else if (key_ == "version") {
+          response_->version = value;
+        }
+        break;
+      case State::kPackage: {
+        auto& package = response_->results.back();
+        if (const auto iter = kIntFields.find(key_);
+            iter != kIntFields.end()) {
+          package.*(iter->second) = value;
+        } else if (const auto iter = kTimeFields.find(key_);
+                   iter != kTimeFields.end()) {
+          package.*(iter->second) =
+              std::chrono::seconds(static_cast<std::int64_t>(value));
+        } else if (key_ == "Popularity") {
+          package.popularity = value;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+
+    return true;
+  }
+
+  RpcResponse* response_;
+
+  State state_ = State::kStart;
+  int skip_depth_ = 0;
+  std::string key_;
+
+  std::vector<std::string> Package::*string_list_ = nullptr;
+  std::vector<Dependency> Package::*dependency_list_ = nullptr;
+};
+
+}  // namespace
 
-// static
-RpcResponse::RpcResponse(const std::string& json_bytes) {
+RpcResponse::RpcResponse(std::string_view json_bytes) {
   if (json_bytes.empty()) {
     return;
   }
 
-  try {
-    *this = nlohmann::json::parse(json_bytes);
-  } catch (const std::exception& e) {
-    type = "error";
-    error = e.what();
+  RpcResponseParser parser(this);
+  if (!nlohmann::json::sax_parse(json_bytes.begin(), json_bytes.end(),
+                                 &parser)) {
+    results.clear();
   }
 }
 
@@ -1,6 +1,8 @@
 #ifndef AUR_RESPONSE_HH_
 #define AUR_RESPONSE_HH_
 
+#include <string_view>
+
 #include "package.hh"
 
 namespace aur {
@@ -44,9 +46,22 @@ struct CloneResponse {
   std::string operation;
 };
 
+struct LsRemoteResponse {
+  explicit LsRemoteResponse(std::string ref) : ref(std::move(ref)) {}
+
+  LsRemoteResponse(const LsRemoteResponse&) = delete;
+  LsRemoteResponse& operator=(const LsRemoteResponse&) = delete;
+
+  LsRemoteResponse(LsRemoteResponse&&) = default;
+  LsRemoteResponse& operator=(LsRemoteResponse&&) = default;
+
+  // The commit hash the remote's HEAD points at.
+  std::string ref;
+};
+
 struct RpcResponse {
   RpcResponse() = default;
-  explicit RpcResponse(const std::string& json_bytes);
+  explicit RpcResponse(std::string_view json_bytes);
 
   RpcResponse(const RpcResponse&) = delete;
   RpcResponse& operator=(const RpcResponse&) = delete;
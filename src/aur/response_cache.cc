@@ -0,0 +1,118 @@
+#include "response_cache.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace aur {
+
+namespace {
+
+// 64-bit FNV-1a. Collisions are tolerable because entries record the full URL
+// they were stored under, and a mismatch is simply treated as a cache miss.
+uint64_t HashUrl(std::string_view url) {
+  uint64_t h = 14695981039346656037ull;
+  for (const char c : url) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+}  // namespace
+
+ResponseCache::Entry::~Entry() {
+  if (addr_ != nullptr) {
+    munmap(addr_, len_);
+  }
+}
+
+ResponseCache::ResponseCache(fs::path root, std::chrono::seconds ttl)
+    : root_(std::move(root)), ttl_(ttl) {
+  std::error_code ec;
+  fs::create_directories(root_, ec);
+}
+
+fs::path ResponseCache::PathForUrl(const std::string& url) const {
+  char name[17];
+  snprintf(name, sizeof(name), "%016llx",
+           static_cast<unsigned long long>(HashUrl(url)));
+  return root_ / name;
+}
+
+std::optional<ResponseCache::Entry> ResponseCache::Get(const std::string& url) {
+  const auto path = PathForUrl(url);
+
+  std::error_code ec;
+  const auto mtime = fs::last_write_time(path, ec);
+  if (ec.value() != 0) {
+    return std::nullopt;
+  }
+
+  if (fs::file_time_type::clock::now() - mtime > ttl_) {
+    fs::remove(path, ec);
+    return std::nullopt;
+  }
+
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+
+  struct stat st{};
+  if (fstat(fd, &st) < 0 || st.st_size == 0) {
+    close(fd);
+    return std::nullopt;
+  }
+
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return std::nullopt;
+  }
+
+  const std::string_view contents(static_cast<const char*>(addr), st.st_size);
+
+  // The first line records the URL the entry was stored under. Verify it to
+  // guard against hash collisions.
+  const auto newline = contents.find('\n');
+  if (newline == std::string_view::npos || contents.substr(0, newline) != url) {
+    munmap(addr, st.st_size);
+    return std::nullopt;
+  }
+
+  return Entry(addr, st.st_size, contents.substr(newline + 1));
+}
+
+void ResponseCache::Put(const std::string& url, std::string_view body) {
+  const auto path = PathForUrl(url);
+
+  auto tmp = path;
+  tmp += ".tmp" + std::to_string(getpid());
+
+  std::ofstream file(tmp, std::ofstream::trunc);
+  if (!file.is_open()) {
+    return;
+  }
+
+  file << url << '\n';
+  file.write(body.data(), body.size());
+  file.close();
+
+  std::error_code ec;
+  if (file.fail()) {
+    fs::remove(tmp, ec);
+    return;
+  }
+
+  fs::rename(tmp, path, ec);
+}
+
+}  // namespace aur
@@ -0,0 +1,73 @@
+#ifndef AUR_RESPONSE_CACHE_HH_
+#define AUR_RESPONSE_CACHE_HH_
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace aur {
+
+// A persistent cache of RPC response bodies, keyed by request URL. Entries are
+// stored one file per URL under the cache root and served back through a
+// read-only memory mapping. An entry expires once it is older than the cache's
+// TTL, measured against the entry file's mtime.
+class ResponseCache {
+ public:
+  // An open, memory mapped cache entry. The view returned by body() remains
+  // valid for the lifetime of the entry.
+  class Entry {
+   public:
+    Entry(void* addr, size_t len, std::string_view body)
+        : addr_(addr), len_(len), body_(body) {}
+    ~Entry();
+
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    Entry(Entry&& other) noexcept
+        : addr_(other.addr_), len_(other.len_), body_(other.body_) {
+      other.addr_ = nullptr;
+    }
+    Entry& operator=(Entry&& other) noexcept {
+      std::swap(addr_, other.addr_);
+      std::swap(len_, other.len_);
+      std::swap(body_, other.body_);
+      return *this;
+    }
+
+    std::string_view body() const { return body_; }
+
+   private:
+    void* addr_;
+    size_t len_;
+    std::string_view body_;
+  };
+
+  ResponseCache(std::filesystem::path root, std::chrono::seconds ttl);
+
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  ResponseCache(ResponseCache&&) = default;
+  ResponseCache& operator=(ResponseCache&&) = default;
+
+  // Returns the cached response body for the given URL, or std::nullopt if no
+  // entry exists or the entry has expired.
+  std::optional<Entry> Get(const std::string& url);
+
+  // Stores a response body for the given URL. Failures to write the entry are
+  // silently ignored -- the cache is purely an optimization.
+  void Put(const std::string& url, std::string_view body);
+
+ private:
+  std::filesystem::path PathForUrl(const std::string& url) const;
+
+  std::filesystem::path root_;
+  std::chrono::seconds ttl_;
+};
+
+}  // namespace aur
+
+#endif  // AUR_RESPONSE_CACHE_HH_
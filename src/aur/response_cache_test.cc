@@ -0,0 +1,45 @@
+#include "response_cache.hh"
+
+#include <filesystem>
+
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+class ResponseCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    root_ = fs::temp_directory_path() / "response_cache_test";
+    fs::remove_all(root_);
+  }
+
+  void TearDown() override { fs::remove_all(root_); }
+
+  fs::path root_;
+};
+
+TEST_F(ResponseCacheTest, RoundTrips) {
+  aur::ResponseCache cache(root_, std::chrono::hours(1));
+
+  cache.Put("https://aur.archlinux.org/rpc?v=5&type=info&arg[]=auracle-git",
+            R"({"resultcount":0,"results":[]})");
+
+  auto entry = cache.Get(
+      "https://aur.archlinux.org/rpc?v=5&type=info&arg[]=auracle-git");
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->body(), R"({"resultcount":0,"results":[]})");
+}
+
+TEST_F(ResponseCacheTest, MissesOnUnknownUrl) {
+  aur::ResponseCache cache(root_, std::chrono::hours(1));
+
+  EXPECT_FALSE(cache.Get("https://aur.archlinux.org/rpc?v=5").has_value());
+}
+
+TEST_F(ResponseCacheTest, ExpiresEntries) {
+  aur::ResponseCache cache(root_, std::chrono::seconds(-1));
+
+  cache.Put("https://aur.archlinux.org/rpc?v=5", "{}");
+
+  EXPECT_FALSE(cache.Get("https://aur.archlinux.org/rpc?v=5").has_value());
+}
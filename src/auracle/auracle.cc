@@ -1,14 +1,24 @@
 #include "auracle.hh"
 
+#include <unistd.h>
+
+#include <algorithm>
 #include <cerrno>
+#include <deque>
 #include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <optional>
 #include <regex>
+#include <sstream>
 #include <string_view>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
+#include "aur/coro.hh"
 #include "aur/response.hh"
 #include "format.hh"
 #include "pacman.hh"
@@ -25,38 +35,56 @@ int ErrorNotEnoughArgs() {
   return -EINVAL;
 }
 
+// Each formatter below accumulates the whole batch into one buffer and
+// flushes it with a single write, rather than issuing a stream operation per
+// field. For large search results the difference is syscall-bound vs not.
 void FormatLong(const std::vector<aur::Package>& packages,
                 const auracle::Pacman* pacman) {
+  std::string out;
   for (const auto& p : packages) {
-    format::Long(p, pacman->GetLocalPackage(p.name));
+    format::LongTo(&out, p, pacman->GetLocalPackage(p.name));
   }
+  std::cout << out;
 }
 
 void FormatNameOnly(const std::vector<aur::Package>& packages) {
+  std::string out;
   for (const auto& p : packages) {
-    format::NameOnly(p);
+    format::NameOnlyTo(&out, p);
   }
+  std::cout << out;
 }
 
 void FormatShort(const std::vector<aur::Package>& packages,
                  const auracle::Pacman* pacman) {
+  std::string out;
   for (const auto& p : packages) {
-    format::Short(p, pacman->GetLocalPackage(p.name));
+    format::ShortTo(&out, p, pacman->GetLocalPackage(p.name));
   }
+  std::cout << out;
 }
 
 void FormatCustom(const std::vector<aur::Package>& packages,
                   const std::string& format) {
+  std::string out;
   for (const auto& p : packages) {
-    format::Custom(format, p);
+    format::CustomTo(&out, format, p);
   }
+  std::cout << out;
 }
 
 void SortUnique(std::vector<aur::Package>* packages,
                 const sort::Sorter& sorter) {
   std::sort(packages->begin(), packages->end(), sorter);
 
-  packages->resize(std::unique(packages->begin(), packages->end()) -
+  // Duplicates only occur when a query was split into several requests, in
+  // which case they're the same package. Comparing names is enough and far
+  // cheaper than full package equality.
+  packages->resize(std::unique(packages->begin(), packages->end(),
+                               [](const aur::Package& a,
+                                  const aur::Package& b) {
+                                 return a.name == b.name;
+                               }) -
                    packages->begin());
 }
 
@@ -82,6 +110,45 @@ std::vector<std::string> NotFoundPackages(
   return missing;
 }
 
+bool IsLiteralTerm(std::string_view term) {
+  return term.find_first_of("^.+*?$[](){}|\\") == std::string_view::npos;
+}
+
+// Matches a single search term against package fields, scanning for a
+// case-insensitive substring when the term is literal and falling back to
+// std::regex only when it actually uses regex syntax.
+class TermMatcher {
+ public:
+  static TermMatcher Literal(std::string term) {
+    TermMatcher matcher;
+    matcher.literal_ = std::move(term);
+    return matcher;
+  }
+
+  static TermMatcher Regex(const std::string& term) {
+    TermMatcher matcher;
+    matcher.regex_.emplace(term, std::regex::icase | std::regex::optimize);
+    return matcher;
+  }
+
+  bool Matches(const std::string& text) const {
+    if (!regex_.has_value()) {
+      return std::search(text.begin(), text.end(), literal_.begin(),
+                         literal_.end(), [](char a, char b) {
+                           return tolower(a) == tolower(b);
+                         }) != text.end();
+    }
+
+    return std::regex_search(text, *regex_);
+  }
+
+ private:
+  TermMatcher() = default;
+
+  std::string literal_;
+  std::optional<std::regex> regex_;
+};
+
 std::string_view GetSearchFragment(std::string_view s) {
   static constexpr char kRegexChars[] = "^.+*?$[](){}|\\";
 
@@ -159,26 +226,50 @@ bool RpcResponseIsFailure(
 }  // namespace
 
 Auracle::Auracle(Options options)
-    : aur_(aur::NewAur(aur::Aur::Options()
-                           .set_baseurl(options.aur_baseurl)
-                           .set_useragent("Auracle/" PROJECT_VERSION))),
-      pacman_(options.pacman) {}
+    : aur_(options.localdump.empty()
+               ? aur::NewAur(aur::Aur::Options()
+                                 .set_baseurl(options.aur_baseurl)
+                                 .set_useragent("Auracle/" PROJECT_VERSION)
+                                 .set_cachedir(options.cachedir)
+                                 .set_cache_ttl(options.cache_ttl)
+                                 .set_session_cachedir(options.cachedir)
+                                 .set_use_rpc_post(options.use_rpc_post)
+                                 .set_max_clone_jobs(options.max_clone_jobs)
+                                 .set_clone_depth(options.clone_depth)
+                                 .set_clone_reference(options.clone_reference))
+               : aur::NewLocalAur(options.localdump)),
+      pacman_(options.pacman),
+      cachedir_(options.cachedir),
+      cache_ttl_(options.cache_ttl) {}
+
+aur::Aur::Stats Auracle::RequestStats() const { return aur_->stats(); }
 
 void Auracle::IteratePackages(std::vector<std::string> args,
                               Auracle::PackageIterator* state) {
   aur::InfoRequest info_request;
 
+  bool have_args = false;
   for (const auto& arg : args) {
     if (state->package_cache.LookupByPkgname(arg) != nullptr) {
       continue;
     }
 
     info_request.AddArg(arg);
+    have_args = true;
   }
 
-  aur_->QueueRpcRequest(
+  if (!have_args) {
+    return;
+  }
+
+  // Count actual fan-out: with POST disabled, a long argument list splits
+  // into several transfers and the callback runs once per split. The batch
+  // below must only fire once the whole level has answered.
+  state->requests_in_flight += aur_->QueueRpcRequest(
       info_request, [this, state, want{std::move(args)}](
                         aur::ResponseWrapper<aur::RpcResponse> response) {
+        --state->requests_in_flight;
+
         if (RpcResponseIsFailure(response)) {
           return -EIO;
         }
@@ -210,20 +301,29 @@ void Auracle::IteratePackages(std::vector<std::string> args,
           }
 
           if (state->recurse) {
-            std::vector<std::string> alldeps;
-            alldeps.reserve(p->depends.size() + p->makedepends.size() +
-                            p->checkdepends.size());
-
             for (auto kind : state->resolve_depends) {
               for (const auto& dep : GetDependenciesByKind(p, kind)) {
-                alldeps.push_back(dep.name);
+                state->pending_deps.emplace_back(dep.name());
               }
             }
-
-            IteratePackages(std::move(alldeps), state);
           }
         }
 
+        // Once every request for the current BFS level has answered, resolve
+        // all newly discovered dependencies with a single batched request.
+        // This costs one round trip per level of the dependency tree rather
+        // than one per package.
+        if (state->requests_in_flight == 0 && !state->pending_deps.empty()) {
+          std::sort(state->pending_deps.begin(), state->pending_deps.end());
+          state->pending_deps.erase(std::unique(state->pending_deps.begin(),
+                                                state->pending_deps.end()),
+                                    state->pending_deps.end());
+
+          auto deps = std::move(state->pending_deps);
+          state->pending_deps.clear();
+          IteratePackages(std::move(deps), state);
+        }
+
         return 0;
       });
 }
@@ -277,25 +377,33 @@ int Auracle::Search(const std::vector<std::string>& args,
     return ErrorNotEnoughArgs();
   }
 
-  std::vector<std::regex> patterns;
+  std::vector<TermMatcher> matchers;
   for (const auto& arg : args) {
+    // Terms without regex syntax (and all terms under --literal) use a
+    // case-insensitive substring scan; libstdc++'s backtracking regex engine
+    // is slow enough to dominate wall time on broad searches.
+    if (!options.allow_regex || IsLiteralTerm(arg)) {
+      matchers.push_back(TermMatcher::Literal(arg));
+      continue;
+    }
+
     try {
-      patterns.emplace_back(arg, std::regex::icase | std::regex::optimize);
+      matchers.push_back(TermMatcher::Regex(arg));
     } catch (const std::regex_error& e) {
       std::cerr << "error: invalid regex: " << arg << "\n";
       return -EINVAL;
     }
   }
 
-  const auto matches = [&patterns, &options](const aur::Package& p) {
-    return std::all_of(patterns.begin(), patterns.end(),
-                       [&p, &options](const std::regex& re) {
+  const auto matches = [&matchers, &options](const aur::Package& p) {
+    return std::all_of(matchers.begin(), matchers.end(),
+                       [&p, &options](const TermMatcher& matcher) {
                          switch (options.search_by) {
                            case aur::SearchRequest::SearchBy::NAME:
-                             return std::regex_search(p.name, re);
+                             return matcher.Matches(p.name);
                            case aur::SearchRequest::SearchBy::NAME_DESC:
-                             return std::regex_search(p.name, re) ||
-                                    std::regex_search(p.description, re);
+                             return matcher.Matches(p.name) ||
+                                    matcher.Matches(p.description);
                            default:
                              // The AUR only matches maintainer and *depends
                              // fields exactly so there's no point in doing
@@ -400,7 +508,46 @@ int Auracle::Show(const std::vector<std::string>& args,
     return ErrorNotEnoughArgs();
   }
 
+  // Bodies stream straight to stdout in request order. The file whose turn
+  // it is writes chunks as they arrive; later files that finish early buffer
+  // until every file before them has been fully printed, so peak memory is
+  // bounded by the in-flight window rather than the file count.
+  struct SourceFileStream {
+    std::string pkgbase;
+    std::string pending;
+    bool complete = false;
+    bool live = false;
+  };
+
   int resultcount = 0;
+  bool print_header = false;
+  std::deque<SourceFileStream> streams;
+  size_t next_stream = 0;
+
+  const auto begin_stream = [&](SourceFileStream& stream) {
+    if (print_header) {
+      std::cout << "### BEGIN " << stream.pkgbase << "/" << options.show_file
+                << "\n";
+    }
+    std::cout << stream.pending;
+    stream.pending.clear();
+    stream.live = true;
+  };
+
+  const auto advance_streams = [&] {
+    while (next_stream < streams.size()) {
+      auto& stream = streams[next_stream];
+      if (!stream.live) {
+        begin_stream(stream);
+      }
+      if (!stream.complete) {
+        break;
+      }
+      std::cout << "\n";
+      ++next_stream;
+    }
+  };
+
   aur_->QueueRpcRequest(
       aur::InfoRequest(args),
       [&](aur::ResponseWrapper<aur::RpcResponse> response) {
@@ -409,13 +556,26 @@ int Auracle::Show(const std::vector<std::string>& args,
         }
 
         resultcount = response.value().resultcount;
-
-        const bool print_header = resultcount > 1;
+        print_header = resultcount > 1;
 
         for (const auto& pkg : response.value().results) {
-          aur_->QueueRawRequest(
+          const size_t index = streams.size();
+          streams.push_back({pkg.pkgbase, {}, false, false});
+
+          aur_->QueueStreamingRawRequest(
               aur::RawRequest::ForSourceFile(pkg, options.show_file),
-              [&options, print_header, pkgbase{pkg.pkgbase}](
+              [&, index](std::string_view chunk) {
+                auto& stream = streams[index];
+                if (index == next_stream) {
+                  if (!stream.live) {
+                    begin_stream(stream);
+                  }
+                  std::cout << chunk;
+                } else {
+                  stream.pending.append(chunk);
+                }
+              },
+              [&, index, pkgbase{pkg.pkgbase}](
                   aur::ResponseWrapper<aur::RawResponse> response) {
                 if (!response.ok()) {
                   std::cerr << "error: request failed: " << response.error()
@@ -437,11 +597,10 @@ int Auracle::Show(const std::vector<std::string>& args,
                     return -EIO;
                 }
 
-                if (print_header) {
-                  std::cout << "### BEGIN " << pkgbase << "/"
-                            << options.show_file << "\n";
+                streams[index].complete = true;
+                if (index == next_stream) {
+                  advance_streams();
                 }
-                std::cout << response.value().bytes << "\n";
                 return 0;
               });
         }
@@ -481,19 +640,13 @@ int Auracle::BuildOrder(const std::vector<std::string>& args,
   std::vector<
       std::tuple<std::string, const aur::Package*, std::vector<std::string>>>
       total_ordering;
-  std::unordered_set<std::string> seen;
-  for (const auto& arg : args) {
-    iter.package_cache.WalkDependencies(
-        arg,
-        [&total_ordering, &seen](
-            const std::string& pkgname, const aur::Package* package,
-            const std::vector<std::string>& dependency_path) {
-          if (seen.emplace(pkgname).second) {
-            total_ordering.emplace_back(pkgname, package, dependency_path);
-          }
-        },
-        options.resolve_depends);
-  }
+  iter.package_cache.WalkDependencies(
+      args,
+      [&total_ordering](std::string_view pkgname, const aur::Package* package,
+                        const std::vector<std::string>& dependency_path) {
+        total_ordering.emplace_back(pkgname, package, dependency_path);
+      },
+      options.resolve_depends);
 
   for (const auto& [name, pkg, dependency_path] : total_ordering) {
     const bool satisfied = pacman_->DependencyIsSatisfied(name);
@@ -537,6 +690,242 @@ int Auracle::BuildOrder(const std::vector<std::string>& args,
   return r;
 }
 
+namespace {
+
+// Suffixes conventionally carried by VCS packages, whose pinned Version
+// field in the AUR metadata says nothing about upstream freshness.
+bool IsDevelPackage(std::string_view pkgname) {
+  for (const std::string_view suffix :
+       {"-git", "-svn", "-hg", "-bzr", "-cvs", "-darcs", "-nightly"}) {
+    if (pkgname.size() > suffix.size() && pkgname.ends_with(suffix)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Resolves the commit a local clone's HEAD points at without spawning git.
+// Returns an empty string when there's no usable clone.
+std::string LocalGitHead(const fs::path& repo) {
+  const auto git = repo / ".git";
+
+  std::ifstream head_file(git / "HEAD");
+  std::string head;
+  if (!std::getline(head_file, head)) {
+    return std::string();
+  }
+
+  constexpr std::string_view kRefPrefix = "ref: ";
+  if (head.compare(0, kRefPrefix.size(), kRefPrefix) != 0) {
+    // Detached HEAD; the line is the commit itself.
+    return head;
+  }
+
+  const auto refname = head.substr(kRefPrefix.size());
+
+  std::ifstream ref_file(git / refname);
+  std::string ref;
+  if (std::getline(ref_file, ref)) {
+    return ref;
+  }
+
+  // The ref may only exist in packed form.
+  std::ifstream packed(git / "packed-refs");
+  std::string line;
+  while (std::getline(packed, line)) {
+    const auto space = line.find(' ');
+    if (space != std::string::npos &&
+        line.compare(space + 1, std::string::npos, refname) == 0) {
+      return line.substr(0, space);
+    }
+  }
+
+  return std::string();
+}
+
+// Remote HEAD seen by a previous ls-remote probe. While the entry hasn't
+// expired, the probe is skipped and the decision to pull is made against
+// this value instead.
+struct DevelHeadState {
+  std::string head;
+  long timestamp;
+};
+
+std::unordered_map<std::string, DevelHeadState> LoadDevelHeads(
+    const std::string& path) {
+  std::unordered_map<std::string, DevelHeadState> state;
+  if (path.empty()) {
+    return state;
+  }
+
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+
+    std::string pkgbase;
+    DevelHeadState entry;
+    if (iss >> pkgbase >> entry.head >> entry.timestamp) {
+      state.emplace(std::move(pkgbase), std::move(entry));
+    }
+  }
+
+  return state;
+}
+
+void SaveDevelHeads(const std::string& path,
+                    const std::unordered_map<std::string, DevelHeadState>&
+                        state) {
+  if (path.empty()) {
+    return;
+  }
+
+  const std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(tmp_path, std::ofstream::trunc);
+    if (!file.is_open()) {
+      return;
+    }
+
+    for (const auto& [pkgbase, entry] : state) {
+      file << pkgbase << " " << entry.head << " " << entry.timestamp << "\n";
+    }
+  }
+
+  std::error_code ec;
+  fs::rename(tmp_path, path, ec);
+  if (ec) {
+    fs::remove(tmp_path, ec);
+  }
+}
+
+}  // namespace
+
+int Auracle::UpdateDevelPackages(const std::vector<std::string>& args) {
+  std::vector<std::string> candidates;
+  pacman_->ForEachLocalPackage(
+      [&](std::string_view pkgname, std::string_view) {
+        if (!IsDevelPackage(pkgname)) {
+          return;
+        }
+
+        if (!args.empty() &&
+            std::find(args.begin(), args.end(), pkgname) == args.end()) {
+          return;
+        }
+
+        candidates.emplace_back(pkgname);
+      });
+
+  if (candidates.empty()) {
+    return 0;
+  }
+
+  // The pkgbase names the clone directory, so resolve it with one bulk info
+  // request before deciding what to probe.
+  std::vector<std::string> pkgbases;
+  aur_->QueueRpcRequest(
+      aur::InfoRequest(candidates),
+      [&](aur::ResponseWrapper<aur::RpcResponse> response) {
+        if (RpcResponseIsFailure(response)) {
+          return -EIO;
+        }
+
+        for (const auto& p : response.value().results) {
+          pkgbases.push_back(p.pkgbase);
+        }
+
+        return 0;
+      });
+
+  auto r = aur_->Wait();
+  if (r < 0) {
+    return r;
+  }
+
+  std::sort(pkgbases.begin(), pkgbases.end());
+  pkgbases.erase(std::unique(pkgbases.begin(), pkgbases.end()),
+                 pkgbases.end());
+
+  const std::string state_path =
+      cachedir_.empty() ? std::string() : cachedir_ + "/devel-heads.state";
+  auto state = LoadDevelHeads(state_path);
+  const long now = std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+
+  int ret = 0;
+  const auto queue_pull = [this, &ret](const std::string& pkgbase) {
+    aur_->QueueCloneRequest(
+        aur::CloneRequest(pkgbase),
+        [&ret, pkgbase](aur::ResponseWrapper<aur::CloneResponse> response) {
+          if (response.ok()) {
+            std::cout << response.value().operation << " complete: "
+                      << (fs::current_path() / pkgbase).string() << "\n";
+          } else {
+            std::cerr << "error: clone failed for " << pkgbase << ": "
+                      << response.error() << "\n";
+            ret = -EIO;
+          }
+          return 0;
+        });
+  };
+
+  for (const auto& pkgbase : pkgbases) {
+    const auto local_head = LocalGitHead(pkgbase);
+    if (local_head.empty()) {
+      // Nothing to compare against yet; fetch the initial clone.
+      queue_pull(pkgbase);
+      continue;
+    }
+
+    if (const auto iter = state.find(pkgbase);
+        iter != state.end() &&
+        now - iter->second.timestamp <= cache_ttl_.count()) {
+      if (iter->second.head != local_head) {
+        queue_pull(pkgbase);
+      }
+      continue;
+    }
+
+    aur_->QueueLsRemoteRequest(
+        aur::LsRemoteRequest(pkgbase),
+        [&, pkgbase, local_head](
+            aur::ResponseWrapper<aur::LsRemoteResponse> response) {
+          if (!response.ok()) {
+            std::cerr << "error: ls-remote failed for " << pkgbase << ": "
+                      << response.error() << "\n";
+            ret = -EIO;
+            return 0;
+          }
+
+          const auto& ref = response.value().ref;
+          if (ref.empty()) {
+            // A probe that produced no ref line is a failure, not an answer;
+            // recording it would pin the pull decision to a bogus head for a
+            // full TTL.
+            std::cerr << "error: ls-remote failed for " << pkgbase
+                      << ": no ref in response\n";
+            ret = -EIO;
+            return 0;
+          }
+
+          state[pkgbase] = {ref, now};
+          if (ref != local_head) {
+            queue_pull(pkgbase);
+          }
+
+          return 0;
+        });
+  }
+
+  r = aur_->Wait();
+  SaveDevelHeads(state_path, state);
+
+  return r < 0 ? r : ret;
+}
+
 int Auracle::Update(const std::vector<std::string>& args,
                     const CommandOptions& options) {
   if (!ChdirIfNeeded(options.directory)) {
@@ -549,7 +938,7 @@ int Auracle::Update(const std::vector<std::string>& args,
     return r;
   }
 
-  if (packages.empty()) {
+  if (packages.empty() && !options.devel) {
     return -ENOENT;
   }
 
@@ -579,43 +968,219 @@ int Auracle::Update(const std::vector<std::string>& args,
     outdated.push_back(p.name);
   }
 
-  IteratePackages(outdated, &iter);
+  if (!outdated.empty()) {
+    IteratePackages(outdated, &iter);
+  }
+
+  r = aur_->Wait();
+  if (r < 0) {
+    return r;
+  }
+
+  if (options.devel) {
+    // Version comparison can't see new commits in a VCS package, so probe
+    // the remotes of installed devel packages and pull only what changed.
+    return UpdateDevelPackages(args);
+  }
+
+  return 0;
+}
+
+namespace {
+
+// Remembered outcome of a previous outdated check. While the local version
+// is unchanged and the entry hasn't expired, the package is answered from
+// this state instead of being sent to the AUR again -- for a fleet poller
+// rechecking hundreds of foreign packages every few minutes, nearly every
+// run is then free of per-package query cost.
+struct OutdatedState {
+  std::string pkgbase;
+  std::string local_version;
+  std::string aur_version;
+  long timestamp;
+};
+
+std::unordered_map<std::string, OutdatedState> LoadOutdatedState(
+    const std::string& path) {
+  std::unordered_map<std::string, OutdatedState> state;
+
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+
+    std::string name;
+    OutdatedState entry;
+    if (iss >> name >> entry.pkgbase >> entry.local_version >>
+        entry.aur_version >> entry.timestamp) {
+      state.emplace(std::move(name), std::move(entry));
+    }
+  }
+
+  return state;
+}
+
+void SaveOutdatedState(
+    const std::string& path,
+    const std::unordered_map<std::string, OutdatedState>& state) {
+  const std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(tmp_path, std::ofstream::trunc);
+    if (!file.is_open()) {
+      return;
+    }
+
+    for (const auto& [name, entry] : state) {
+      file << name << " " << entry.pkgbase << " " << entry.local_version << " "
+           << entry.aur_version << " " << entry.timestamp << "\n";
+    }
+  }
+
+  std::error_code ec;
+  fs::rename(tmp_path, path, ec);
+  if (ec) {
+    fs::remove(tmp_path, ec);
+  }
+}
+
+// Marks each result whose AUR version is newer than the installed one.
+// vercmp is pure string crunching, so the comparisons fan out across
+// threads once the result set is large enough to be worth it.
+std::vector<char> FindNewerVersions(
+    const std::vector<aur::Package>& results,
+    const std::vector<std::optional<Pacman::Package>>& locals) {
+  std::vector<char> newer(results.size(), 0);
+
+  const auto compare_range = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      newer[i] = locals[i] && Pacman::Vercmp(results[i].version,
+                                             locals[i]->pkgver) > 0;
+    }
+  };
+
+  constexpr size_t kParallelThreshold = 512;
+  const size_t num_threads =
+      std::max(1u, std::min(std::thread::hardware_concurrency(), 4u));
+  if (results.size() < kParallelThreshold || num_threads == 1) {
+    compare_range(0, results.size());
+    return newer;
+  }
+
+  std::vector<std::thread> threads;
+  const size_t chunk = (results.size() + num_threads - 1) / num_threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    const size_t begin = t * chunk;
+    const size_t end = std::min(begin + chunk, results.size());
+    if (begin < end) {
+      threads.emplace_back(compare_range, begin, end);
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
 
-  return aur_->Wait();
+  return newer;
 }
 
+}  // namespace
+
 int Auracle::GetOutdatedPackages(const std::vector<std::string>& args,
                                  std::vector<aur::Package>* packages) {
+  const std::string state_path =
+      cachedir_.empty() ? std::string() : cachedir_ + "/outdated.state";
+  auto state =
+      state_path.empty()
+          ? std::unordered_map<std::string, OutdatedState>()
+          : LoadOutdatedState(state_path);
+
+  const long now = std::chrono::duration_cast<std::chrono::seconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+
   aur::InfoRequest info_request;
+  bool queried_any = false;
+
+  // The visitor sees string_views over alpm-owned storage; enumerating the
+  // local database allocates nothing, and names flow straight through to
+  // InfoRequest::AddArg.
+  pacman_->ForEachLocalPackage([&](std::string_view pkgname,
+                                   std::string_view pkgver) {
+    if (!args.empty() &&
+        std::find(args.cbegin(), args.cend(), pkgname) == args.cend()) {
+      return;
+    }
+
+    if (const auto iter =
+            state.empty() ? state.end() : state.find(std::string(pkgname));
+        iter != state.end() && iter->second.local_version == pkgver &&
+        now - iter->second.timestamp <= cache_ttl_.count()) {
+      // Fresh state from a previous run; answer without the network. The
+      // timestamp is deliberately not refreshed so the package is re-queried
+      // once the entry expires.
+      const auto& entry = iter->second;
+      if (Pacman::Vercmp(entry.aur_version, std::string(pkgver)) > 0) {
+        aur::Package package;
+        package.name = std::string(pkgname);
+        package.pkgbase = entry.pkgbase;
+        package.version = entry.aur_version;
+        packages->push_back(std::move(package));
+      }
+      return;
+    }
+
+    info_request.AddArg(pkgname);
+    queried_any = true;
+  });
+
+  std::vector<aur::Package> results;
+  if (queried_any) {
+    aur_->QueueRpcRequest(
+        info_request, [&](aur::ResponseWrapper<aur::RpcResponse> response) {
+          if (RpcResponseIsFailure(response)) {
+            return -EIO;
+          }
+
+          auto r = response.value().results;
+          std::move(r.begin(), r.end(), std::back_inserter(results));
+          return 0;
+        });
 
-  auto local_pkgs = pacman_->LocalPackages();
-  for (const auto& pkg : local_pkgs) {
-    if (args.empty() ||
-        std::find(args.cbegin(), args.cend(), pkg.pkgname) != args.cend()) {
-      info_request.AddArg(pkg.pkgname);
+    const int r = aur_->Wait();
+    if (r < 0) {
+      return r;
     }
   }
 
-  aur_->QueueRpcRequest(
-      info_request, [&](aur::ResponseWrapper<aur::RpcResponse> response) {
-        if (RpcResponseIsFailure(response)) {
-          return -EIO;
-        }
+  std::vector<std::optional<Pacman::Package>> locals;
+  locals.reserve(results.size());
+  for (const auto& result : results) {
+    locals.push_back(pacman_->GetLocalPackage(result.name));
+  }
 
-        auto results = response.value().results;
-        std::copy_if(std::make_move_iterator(results.begin()),
-                     std::make_move_iterator(results.end()),
-                     std::back_inserter(*packages), [&](const aur::Package& p) {
-                       auto local = pacman_->GetLocalPackage(p.name);
+  const auto newer = FindNewerVersions(results, locals);
 
-                       return local &&
-                              Pacman::Vercmp(p.version, local->pkgver) > 0;
-                     });
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (locals[i] && !state_path.empty()) {
+      state[results[i].name] = OutdatedState{
+          results[i].pkgbase, locals[i]->pkgver, results[i].version, now};
+    }
 
-        return 0;
-      });
+    if (newer[i]) {
+      packages->push_back(std::move(results[i]));
+    }
+  }
+
+  if (!state_path.empty()) {
+    // Drop entries for packages that are no longer installed, so removals
+    // don't ride along in the state file forever.
+    std::erase_if(state, [&](const auto& entry) {
+      return !pacman_->GetLocalPackage(entry.first).has_value();
+    });
+
+    SaveOutdatedState(state_path, state);
+  }
 
-  return aur_->Wait();
+  return 0;
 }
 
 int Auracle::Outdated(const std::vector<std::string>& args,
@@ -649,33 +1214,39 @@ int Auracle::Outdated(const std::vector<std::string>& args,
 
 namespace {
 
-int RawSearchDone(aur::ResponseWrapper<aur::RawResponse> response) {
+aur::Task PrintRawResponse(aur::Aur& aur, const aur::RpcRequest& request,
+                           int* result) {
+  auto response = co_await aur::AwaitRawRequest(aur, request);
   if (!response.ok()) {
     std::cerr << "error: request failed: " << response.error() << "\n";
-    return -EIO;
+    *result = -EIO;
+    co_return;
   }
 
   std::cout << response.value().bytes << "\n";
-  return 0;
 }
 
 }  // namespace
 
 int Auracle::RawSearch(const std::vector<std::string>& args,
                        const CommandOptions& options) {
+  int result = 0;
   for (const auto& arg : args) {
-    aur_->QueueRawRequest(aur::SearchRequest(options.search_by, arg),
-                          &RawSearchDone);
+    PrintRawResponse(*aur_, aur::SearchRequest(options.search_by, arg),
+                     &result);
   }
 
-  return aur_->Wait();
+  const int r = aur_->Wait();
+  return r < 0 ? r : result;
 }
 
 int Auracle::RawInfo(const std::vector<std::string>& args,
                      const CommandOptions&) {
-  aur_->QueueRawRequest(aur::InfoRequest(args), &RawSearchDone);
+  int result = 0;
+  PrintRawResponse(*aur_, aur::InfoRequest(args), &result);
 
-  return aur_->Wait();
+  const int r = aur_->Wait();
+  return r < 0 ? r : result;
 }
 
 }  // namespace auracle
@@ -1,6 +1,7 @@
 #ifndef AURACLE_AURACLE_HH_
 #define AURACLE_AURACLE_HH_
 
+#include <chrono>
 #include <set>
 #include <string>
 #include <vector>
@@ -31,9 +32,55 @@ class Auracle {
       return *this;
     }
 
+    Options& set_cachedir(std::string cachedir) {
+      this->cachedir = std::move(cachedir);
+      return *this;
+    }
+
+    Options& set_cache_ttl(std::chrono::seconds cache_ttl) {
+      this->cache_ttl = cache_ttl;
+      return *this;
+    }
+
+    // Answer RPC requests from a local metadata dump when non-empty.
+    Options& set_localdump(std::string localdump) {
+      this->localdump = std::move(localdump);
+      return *this;
+    }
+
+    // Send RPC queries as POSTs with the argument list in the request body.
+    // False falls back to GETs, for servers that don't accept POST on the
+    // RPC endpoint.
+    Options& set_use_rpc_post(bool use_rpc_post) {
+      this->use_rpc_post = use_rpc_post;
+      return *this;
+    }
+
+    Options& set_max_clone_jobs(int max_clone_jobs) {
+      this->max_clone_jobs = max_clone_jobs;
+      return *this;
+    }
+
+    Options& set_clone_depth(int clone_depth) {
+      this->clone_depth = clone_depth;
+      return *this;
+    }
+
+    Options& set_clone_reference(std::string clone_reference) {
+      this->clone_reference = std::move(clone_reference);
+      return *this;
+    }
+
     std::string aur_baseurl;
     Pacman* pacman = nullptr;
     bool quiet = false;
+    std::string cachedir;
+    std::chrono::seconds cache_ttl = std::chrono::minutes(5);
+    std::string localdump;
+    bool use_rpc_post = true;
+    int max_clone_jobs = 5;
+    int clone_depth = 0;
+    std::string clone_reference;
   };
 
   explicit Auracle(Options options);
@@ -60,6 +107,7 @@ class Auracle {
     std::set<DependencyKind> resolve_depends = {DependencyKind::Depend,
                                                 DependencyKind::CheckDepend,
                                                 DependencyKind::MakeDepend};
+    bool devel = false;
   };
 
   int BuildOrder(const std::vector<std::string>& args,
@@ -79,6 +127,9 @@ class Auracle {
   int Update(const std::vector<std::string>& args,
              const CommandOptions& options);
 
+  // Transfer timing aggregated over all requests issued so far.
+  aur::Aur::Stats RequestStats() const;
+
  private:
   struct PackageIterator {
     using PackageCallback = std::function<void(const aur::Package&)>;
@@ -94,15 +145,28 @@ class Auracle {
 
     const PackageCallback callback;
     PackageCache package_cache;
+
+    // Level-order resolution state. Dependency names discovered by in-flight
+    // info requests accumulate here and are coalesced into a single batched
+    // request once the current BFS level has fully resolved.
+    int requests_in_flight = 0;
+    std::vector<std::string> pending_deps;
   };
 
   int GetOutdatedPackages(const std::vector<std::string>& args,
                           std::vector<aur::Package>* packages);
 
+  int UpdateDevelPackages(const std::vector<std::string>& args);
+
   void IteratePackages(std::vector<std::string> args, PackageIterator* state);
 
   std::unique_ptr<aur::Aur> aur_;
   Pacman* pacman_;
+
+  // Home and lifetime of incremental state, e.g. the outdated-check state
+  // file. Empty cachedir_ disables such state entirely.
+  std::string cachedir_;
+  std::chrono::seconds cache_ttl_;
 };
 
 }  // namespace auracle
@@ -0,0 +1,270 @@
+#include "daemon.hh"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+namespace auracle {
+
+namespace {
+
+// The wire protocol is deliberately simple. A request is a header line
+//
+//   <command> <args_len>
+//
+// followed by args_len bytes in which every argument ends with a NUL, and a
+// response is a header line "<status> <stdout_len> <stderr_len>" followed by
+// the two captured output payloads. Arguments are framed by length rather
+// than re-tokenized from whitespace so that values with embedded spaces --
+// a --format string, say -- survive the trip intact.
+
+bool ReadLine(int fd, std::string* line) {
+  line->clear();
+
+  char c;
+  for (;;) {
+    const auto n = read(fd, &c, 1);
+    if (n <= 0) {
+      return false;
+    }
+
+    if (c == '\n') {
+      return true;
+    }
+
+    line->push_back(c);
+  }
+}
+
+bool ReadExactly(int fd, size_t len, std::string* data) {
+  data->clear();
+  data->reserve(len);
+
+  char buf[4096];
+  while (len > 0) {
+    const auto n = read(fd, buf, std::min(len, sizeof(buf)));
+    if (n <= 0) {
+      return false;
+    }
+
+    data->append(buf, n);
+    len -= n;
+  }
+
+  return true;
+}
+
+bool WriteAll(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    // MSG_NOSIGNAL: a peer that hangs up mid-response (e.g. the client's
+    // output piped into head) must surface as EPIPE here, not as a SIGPIPE
+    // that kills the resident daemon.
+    const auto n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    data += n;
+    len -= n;
+  }
+
+  return true;
+}
+
+int Connect(const std::string& socket_path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    return -1;
+  }
+  strcpy(addr.sun_path, socket_path.c_str());
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+
+  if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+}  // namespace
+
+Daemon::Daemon(Dispatcher dispatcher) : dispatcher_(std::move(dispatcher)) {}
+
+int Daemon::Run(const std::string& socket_path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    return -ENAMETOOLONG;
+  }
+  strcpy(addr.sun_path, socket_path.c_str());
+
+  const int server_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (server_fd < 0) {
+    return -errno;
+  }
+
+  unlink(socket_path.c_str());
+  if (bind(server_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(server_fd, SOMAXCONN) < 0) {
+    const int r = -errno;
+    close(server_fd);
+    return r;
+  }
+
+  for (;;) {
+    const int client_fd = accept(server_fd, nullptr, nullptr);
+    if (client_fd < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    const bool quit = HandleClient(client_fd);
+    close(client_fd);
+
+    if (quit) {
+      break;
+    }
+  }
+
+  close(server_fd);
+  unlink(socket_path.c_str());
+
+  return 0;
+}
+
+bool Daemon::HandleClient(int fd) {
+  std::string line;
+  if (!ReadLine(fd, &line)) {
+    return false;
+  }
+
+  std::istringstream iss(line);
+
+  std::string command;
+  size_t args_len;
+  if (!(iss >> command >> args_len)) {
+    return false;
+  }
+
+  std::string packed;
+  if (!ReadExactly(fd, args_len, &packed)) {
+    return false;
+  }
+
+  std::vector<std::string> args;
+  std::string_view remaining(packed);
+  while (!remaining.empty()) {
+    const auto arg = remaining.substr(0, remaining.find('\0'));
+    args.emplace_back(arg);
+    remaining.remove_prefix(std::min(remaining.size(), arg.size() + 1));
+  }
+
+  if (command == "quit") {
+    WriteAll(fd, "0 0 0\n", 6);
+    return true;
+  }
+
+  // Run the command with both output streams captured so they can be
+  // replayed verbatim on the client's own stdout and stderr.
+  std::ostringstream captured_out;
+  std::ostringstream captured_err;
+  auto* cout_buf = std::cout.rdbuf(captured_out.rdbuf());
+  auto* cerr_buf = std::cerr.rdbuf(captured_err.rdbuf());
+
+  const int status = dispatcher_(command, args);
+
+  std::cout.rdbuf(cout_buf);
+  std::cerr.rdbuf(cerr_buf);
+
+  const auto out = captured_out.str();
+  const auto err = captured_err.str();
+
+  const auto header = std::to_string(status) + " " +
+                      std::to_string(out.size()) + " " +
+                      std::to_string(err.size()) + "\n";
+
+  WriteAll(fd, header.data(), header.size()) &&
+      WriteAll(fd, out.data(), out.size()) &&
+      WriteAll(fd, err.data(), err.size());
+
+  return false;
+}
+
+std::string DefaultSocketPath() {
+  if (const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+      runtime_dir != nullptr && *runtime_dir != '\0') {
+    return std::string(runtime_dir) + "/auracle.sock";
+  }
+
+  return "/tmp/auracle." + std::to_string(getuid()) + ".sock";
+}
+
+std::optional<int> QueryDaemon(const std::string& socket_path,
+                               std::string_view command,
+                               const std::vector<std::string>& args) {
+  const int fd = Connect(socket_path);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+
+  std::string packed;
+  for (const auto& arg : args) {
+    packed.append(arg);
+    packed.push_back('\0');
+  }
+
+  std::string request(command);
+  request.append(" ").append(std::to_string(packed.size()));
+  request.push_back('\n');
+  request.append(packed);
+
+  std::string header;
+  if (!WriteAll(fd, request.data(), request.size()) ||
+      !ReadLine(fd, &header)) {
+    close(fd);
+    return std::nullopt;
+  }
+
+  std::istringstream iss(header);
+  int status;
+  size_t out_len, err_len;
+  if (!(iss >> status >> out_len >> err_len)) {
+    close(fd);
+    return std::nullopt;
+  }
+
+  std::string payload;
+  if (ReadExactly(fd, out_len, &payload)) {
+    fwrite(payload.data(), 1, payload.size(), stdout);
+  }
+  if (ReadExactly(fd, err_len, &payload)) {
+    fwrite(payload.data(), 1, payload.size(), stderr);
+  }
+
+  close(fd);
+  return status;
+}
+
+}  // namespace auracle
+
+/* vim: set et ts=2 sw=2: */
@@ -0,0 +1,48 @@
+#ifndef AURACLE_DAEMON_HH_
+#define AURACLE_DAEMON_HH_
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace auracle {
+
+// Serves commands over a unix socket from a long-lived process. A resident
+// daemon keeps the alpm handle, pacman config and warm HTTP connections
+// across requests, so high-frequency callers (completion hooks, status
+// bars) skip the per-process setup cost entirely.
+class Daemon {
+ public:
+  // Executes a single command with its arguments and returns its status.
+  using Dispatcher = std::function<int(const std::string& command,
+                                       const std::vector<std::string>& args)>;
+
+  explicit Daemon(Dispatcher dispatcher);
+
+  // Binds the unix socket at socket_path and serves requests, one
+  // connection at a time, until a client sends "quit". Returns a negative
+  // errno if the socket can't be set up.
+  int Run(const std::string& socket_path);
+
+ private:
+  // Returns true if the client asked the daemon to quit.
+  bool HandleClient(int fd);
+
+  Dispatcher dispatcher_;
+};
+
+// Returns the default daemon socket path for this user.
+std::string DefaultSocketPath();
+
+// Sends a single command to the daemon at socket_path and replays its
+// captured stdout and stderr. Returns the command's status, or std::nullopt
+// if no daemon is reachable there.
+std::optional<int> QueryDaemon(const std::string& socket_path,
+                               std::string_view command,
+                               const std::vector<std::string>& args);
+
+}  // namespace auracle
+
+#endif  // AURACLE_DAEMON_HH_
@@ -136,12 +136,19 @@ FMT_END_NAMESPACE
 
 namespace format {
 
+void NameOnlyTo(std::string* out, const aur::Package& package) {
+  fmt::format_to(std::back_inserter(*out), fmt::runtime(terminal::Bold("{}\n")),
+                 package.name);
+}
+
 void NameOnly(const aur::Package& package) {
-  std::cout << fmt::format(terminal::Bold("{}\n"), package.name);
+  std::string out;
+  NameOnlyTo(&out, package);
+  std::cout << out;
 }
 
-void Short(const aur::Package& package,
-           const std::optional<auracle::Pacman::Package>& local_package) {
+void ShortTo(std::string* out, const aur::Package& package,
+             const std::optional<auracle::Pacman::Package>& local_package) {
   namespace t = terminal;
 
   const auto& l = local_package;
@@ -159,14 +166,20 @@ void Short(const aur::Package& package,
         fmt::format("[installed: {}]", local_ver_color(l->pkgver));
   }
 
-  std::cout << fmt::format("{}{} {} ({}, {}) {}\n    {}\n",
-                           t::BoldMagenta("aur/"), t::Bold(p.name),
-                           ood_color(p.version), p.votes, p.popularity,
-                           installed_package, p.description);
+  fmt::format_to(std::back_inserter(*out), "{}{} {} ({}, {}) {}\n    {}\n",
+                 t::BoldMagenta("aur/"), t::Bold(p.name), ood_color(p.version),
+                 p.votes, p.popularity, installed_package, p.description);
 }
 
-void Long(const aur::Package& package,
-          const std::optional<auracle::Pacman::Package>& local_package) {
+void Short(const aur::Package& package,
+           const std::optional<auracle::Pacman::Package>& local_package) {
+  std::string out;
+  ShortTo(&out, package, local_package);
+  std::cout << out;
+}
+
+void LongTo(std::string* out, const aur::Package& package,
+            const std::optional<auracle::Pacman::Package>& local_package) {
   namespace t = terminal;
 
   const auto& l = local_package;
@@ -185,42 +198,48 @@ void Long(const aur::Package& package,
         fmt::format(" [installed: {}]", local_ver_color(l->pkgver));
   }
 
-  std::cout << fmt::format("{}", Field("Repository", t::BoldMagenta("aur")));
-  std::cout << fmt::format("{}", Field("Name", p.name));
-  std::cout << fmt::format(
-      "{}", Field("Version", ood_color(p.version) + installed_package));
+  const auto field = [out](auto&& f) {
+    fmt::format_to(std::back_inserter(*out), "{}", f);
+  };
+
+  field(Field("Repository", t::BoldMagenta("aur")));
+  field(Field("Name", p.name));
+  field(Field("Version", ood_color(p.version) + installed_package));
 
   if (p.name != p.pkgbase) {
-    std::cout << fmt::format("{}", Field("PackageBase", p.pkgbase));
+    field(Field("PackageBase", p.pkgbase));
   }
 
-  std::cout << fmt::format("{}", Field("URL", t::BoldCyan(p.upstream_url)));
-  std::cout << fmt::format(
-      "{}", Field("AUR Page",
-                  t::BoldCyan("https://aur.archlinux.org/packages/" + p.name)));
-  std::cout << fmt::format("{}", Field("Keywords", p.keywords));
-  std::cout << fmt::format("{}", Field("Groups", p.groups));
-  std::cout << fmt::format("{}", Field("Depends On", p.depends));
-  std::cout << fmt::format("{}", Field("Makedepends", p.makedepends));
-  std::cout << fmt::format("{}", Field("Checkdepends", p.checkdepends));
-  std::cout << fmt::format("{}", Field("Provides", p.provides));
-  std::cout << fmt::format("{}", Field("Conflicts With", p.conflicts));
-  std::cout << fmt::format("{}",
-                           Field("Optional Deps", OptDepends{p.optdepends}));
-  std::cout << fmt::format("{}", Field("Replaces", p.replaces));
-  std::cout << fmt::format("{}", Field("Licenses", p.licenses));
-  std::cout << fmt::format("{}", Field("Votes", p.votes));
-  std::cout << fmt::format("{}", Field("Popularity", p.popularity));
-  std::cout << fmt::format(
-      "{}",
-      Field("Maintainer", p.maintainer.empty() ? "(orphan)" : p.maintainer));
-  std::cout << fmt::format("{}", Field("Submitted", p.submitted));
-  std::cout << fmt::format("{}", Field("Last Modified", p.modified));
+  field(Field("URL", t::BoldCyan(p.upstream_url)));
+  field(Field("AUR Page",
+              t::BoldCyan("https://aur.archlinux.org/packages/" + p.name)));
+  field(Field("Keywords", p.keywords));
+  field(Field("Groups", p.groups));
+  field(Field("Depends On", p.depends));
+  field(Field("Makedepends", p.makedepends));
+  field(Field("Checkdepends", p.checkdepends));
+  field(Field("Provides", p.provides));
+  field(Field("Conflicts With", p.conflicts));
+  field(Field("Optional Deps", OptDepends{p.optdepends}));
+  field(Field("Replaces", p.replaces));
+  field(Field("Licenses", p.licenses));
+  field(Field("Votes", p.votes));
+  field(Field("Popularity", p.popularity));
+  field(Field("Maintainer", p.maintainer.empty() ? "(orphan)" : p.maintainer));
+  field(Field("Submitted", p.submitted));
+  field(Field("Last Modified", p.modified));
   if (p.out_of_date != std::chrono::seconds::zero()) {
-    std::cout << fmt::format("{}", Field("Out of Date", p.out_of_date));
+    field(Field("Out of Date", p.out_of_date));
   }
-  std::cout << fmt::format("{}", Field("Description", p.description));
-  std::cout << fmt::format("\n");
+  field(Field("Description", p.description));
+  out->push_back('\n');
+}
+
+void Long(const aur::Package& package,
+          const std::optional<auracle::Pacman::Package>& local_package) {
+  std::string out;
+  LongTo(&out, package, local_package);
+  std::cout << out;
 }
 
 void Update(const auracle::Pacman::Package& from, const aur::Package& to) {
@@ -236,7 +255,7 @@ void FormatCustomTo(std::string& out, const std::string& format,
                     const aur::Package& package) {
   // clang-format off
   fmt::format_to(
-      std::back_inserter(out), format,
+      std::back_inserter(out), fmt::runtime(format),
       fmt::arg("name", package.name),
       fmt::arg("description", package.description),
       fmt::arg("maintainer", package.maintainer),
@@ -267,12 +286,16 @@ void FormatCustomTo(std::string& out, const std::string& format,
 
 }  // namespace
 
+void CustomTo(std::string* out, const std::string& format,
+              const aur::Package& package) {
+  FormatCustomTo(*out, format, package);
+  out->push_back('\n');
+}
+
 void Custom(const std::string& format, const aur::Package& package) {
   std::string out;
-
-  FormatCustomTo(out, format, package);
-
-  std::cout << out << "\n";
+  CustomTo(&out, format, package);
+  std::cout << out;
 }
 
 bool FormatIsValid(const std::string& format, std::string* error) {
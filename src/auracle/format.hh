@@ -1,6 +1,7 @@
 #ifndef AURACLE_FORMAT_HH_
 #define AURACLE_FORMAT_HH_
 
+#include <string>
 #include <string_view>
 
 #include "aur/package.hh"
@@ -16,6 +17,17 @@ void Long(const aur::Package& package,
           const std::optional<auracle::Pacman::Package>& local_package);
 void Custom(const std::string& format, const aur::Package& package);
 
+// Variants which append to a caller-owned buffer rather than writing to
+// stdout, letting callers format a whole batch of packages and flush it in
+// one write instead of a stream operation per field.
+void NameOnlyTo(std::string* out, const aur::Package& package);
+void ShortTo(std::string* out, const aur::Package& package,
+             const std::optional<auracle::Pacman::Package>& local_package);
+void LongTo(std::string* out, const aur::Package& package,
+            const std::optional<auracle::Pacman::Package>& local_package);
+void CustomTo(std::string* out, const std::string& format,
+              const aur::Package& package);
+
 bool FormatIsValid(const std::string& format, std::string* error);
 
 }  // namespace format
@@ -1,15 +1,17 @@
 #include "package_cache.hh"
 
+#include <algorithm>
 #include <iostream>
+#include <string_view>
 #include <unordered_set>
 
 namespace auracle {
 
 std::pair<const aur::Package*, bool> PackageCache::AddPackage(
     aur::Package package) {
-  const auto iter = std::find(packages_.begin(), packages_.end(), package);
-  if (iter != packages_.cend()) {
-    return {&*iter, false};
+  const auto iter = index_by_pkgname_.find(package.name);
+  if (iter != index_by_pkgname_.end()) {
+    return {&packages_[iter->second], false};
   }
 
   const auto& p = packages_.emplace_back(std::move(package));
@@ -20,90 +22,115 @@ std::pair<const aur::Package*, bool> PackageCache::AddPackage(
 }
 
 const aur::Package* PackageCache::LookupByPkgname(
-    const std::string& pkgname) const {
+    std::string_view pkgname) const {
   const auto iter = index_by_pkgname_.find(pkgname);
   return iter == index_by_pkgname_.end() ? nullptr : &packages_[iter->second];
 }
 
 const aur::Package* PackageCache::LookupByPkgbase(
-    const std::string& pkgbase) const {
+    std::string_view pkgbase) const {
   const auto iter = index_by_pkgbase_.find(pkgbase);
   return iter == index_by_pkgbase_.end() ? nullptr : &packages_[iter->second];
 }
 
-class DependencyPath : public std::vector<std::string> {
- public:
-  class Step {
-   public:
-    Step(DependencyPath& dependency_path, std::string step)
-        : dependency_path_(dependency_path) {
-      MaybeReportCycle(step);
+namespace {
 
-      dependency_path_.push_back(step);
-    }
-
-    ~Step() { dependency_path_.pop_back(); }
-
-   private:
-    void MaybeReportCycle(const std::string& step) {
-      auto cycle_start =
-          std::find(dependency_path_.cbegin(), dependency_path_.cend(), step);
-      if (cycle_start == dependency_path_.cend()) {
-        return;
-      }
+void ReportCycle(const std::vector<std::string>& dependency_path,
+                 std::string_view step) {
+  auto cycle_start =
+      std::find(dependency_path.cbegin(), dependency_path.cend(), step);
 
-      std::cerr << "warning: found dependency cycle:";
+  std::cerr << "warning: found dependency cycle:";
 
-      // Print the path leading up to the start of the cycle
-      auto iter = dependency_path_.cbegin();
-      while (iter != cycle_start) {
-        std::cerr << " " << *iter << " ->";
-        ++iter;
-      }
+  // Print the path leading up to the start of the cycle
+  auto iter = dependency_path.cbegin();
+  while (iter != cycle_start) {
+    std::cerr << " " << *iter << " ->";
+    ++iter;
+  }
 
-      // Print the cycle itself, wrapped in brackets
-      std::cerr << " [ " << *iter;
-      ++iter;
-      while (iter != dependency_path_.cend()) {
-        std::cerr << " -> " << *iter;
-        ++iter;
-      }
+  // Print the cycle itself, wrapped in brackets
+  std::cerr << " [ " << *iter;
+  ++iter;
+  while (iter != dependency_path.cend()) {
+    std::cerr << " -> " << *iter;
+    ++iter;
+  }
 
-      std::cerr << " -> " << *cycle_start << " ]\n";
-    }
+  std::cerr << " -> " << *cycle_start << " ]\n";
+}
 
-    DependencyPath& dependency_path_;
-  };
-};
+}  // namespace
 
 void PackageCache::WalkDependencies(
     const std::string& name, WalkDependenciesFn cb,
     const std::set<DependencyKind>& dependency_kinds) const {
-  std::unordered_set<std::string> visited;
-  DependencyPath dependency_path;
+  WalkDependencies(std::vector<std::string>{name}, std::move(cb),
+                   dependency_kinds);
+}
+
+void PackageCache::WalkDependencies(
+    const std::vector<std::string>& names, WalkDependenciesFn cb,
+    const std::set<DependencyKind>& dependency_kinds) const {
+  // Names point into the cache (or the caller's roots), both of which are
+  // stable for the duration of the walk, so frames and the bookkeeping sets
+  // can refer to them without copying at each step.
+  struct Frame {
+    std::string_view name;
+    bool expanded;
+  };
 
-  std::function<void(std::string)> walk;
-  walk = [&](const std::string& pkgname) {
-    DependencyPath::Step step(dependency_path, pkgname);
+  std::unordered_set<std::string_view> visited;
+  std::unordered_set<std::string_view> on_path;
+  std::vector<std::string> dependency_path;
+  std::vector<Frame> stack;
+
+  for (const auto& name : names) {
+    stack.push_back({name, false});
+
+    while (!stack.empty()) {
+      const std::string_view pkgname = stack.back().name;
+
+      // A fully expanded frame has had all of its dependencies reported
+      // already; report the package itself and leave the path.
+      if (stack.back().expanded) {
+        cb(pkgname, LookupByPkgname(pkgname), dependency_path);
+        on_path.erase(pkgname);
+        dependency_path.pop_back();
+        stack.pop_back();
+        continue;
+      }
 
-    if (!visited.insert(pkgname).second) {
-      return;
-    }
+      if (on_path.count(pkgname) > 0) {
+        ReportCycle(dependency_path, pkgname);
+        stack.pop_back();
+        continue;
+      }
+
+      if (!visited.insert(pkgname).second) {
+        stack.pop_back();
+        continue;
+      }
 
-    const auto* pkg = LookupByPkgname(pkgname);
-    if (pkg != nullptr) {
+      stack.back().expanded = true;
+      on_path.insert(pkgname);
+      dependency_path.emplace_back(pkgname);
+
+      const auto* pkg = LookupByPkgname(pkgname);
+      if (pkg == nullptr) {
+        continue;
+      }
+
+      // Push dependencies in reverse so they are expanded in declared order.
+      const auto first_child = stack.size();
       for (auto kind : dependency_kinds) {
-        const auto& deplist = GetDependenciesByKind(pkg, kind);
-        for (const auto& dep : deplist) {
-          walk(dep.name);
+        for (const auto& dep : GetDependenciesByKind(pkg, kind)) {
+          stack.push_back({dep.name(), false});
         }
       }
+      std::reverse(stack.begin() + first_child, stack.end());
     }
-
-    cb(pkgname, pkg, dependency_path);
-  };
-
-  walk(name);
+  }
 }
 
 }  // namespace auracle
@@ -3,6 +3,7 @@
 
 #include <functional>
 #include <set>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 
@@ -24,27 +25,46 @@ class PackageCache {
 
   std::pair<const aur::Package*, bool> AddPackage(aur::Package package);
 
-  const aur::Package* LookupByPkgname(const std::string& pkgname) const;
-  const aur::Package* LookupByPkgbase(const std::string& pkgbase) const;
+  const aur::Package* LookupByPkgname(std::string_view pkgname) const;
+  const aur::Package* LookupByPkgbase(std::string_view pkgbase) const;
 
   int size() const { return packages_.size(); }
 
   bool empty() const { return size() == 0; }
 
   using WalkDependenciesFn =
-      std::function<void(const std::string& name, const aur::Package* package,
+      std::function<void(std::string_view name, const aur::Package* package,
                          const std::vector<std::string>& dependency_path)>;
   void WalkDependencies(const std::string& name, WalkDependenciesFn cb,
                         const std::set<DependencyKind>& dependency_kinds) const;
 
+  // Walks several roots in a single pass, sharing visited state between them
+  // so that subtrees reachable from more than one root are traversed and
+  // reported only once.
+  void WalkDependencies(const std::vector<std::string>& names,
+                        WalkDependenciesFn cb,
+                        const std::set<DependencyKind>& dependency_kinds) const;
+
  private:
+  // Transparent hashing lets lookups take string_views (e.g. dependency
+  // names, which are views into their depstring) without materializing a
+  // std::string per query.
+  struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view sv) const {
+      return std::hash<std::string_view>()(sv);
+    }
+  };
+  using NameIndex =
+      std::unordered_map<std::string, int, StringHash, std::equal_to<>>;
+
   std::vector<aur::Package> packages_;
 
   // We store integer indicies into the packages_ vector above rather than
   // pointers to the packages. This allows the vector to resize and not
   // invalidate our index maps.
-  std::unordered_map<std::string, int> index_by_pkgname_;
-  std::unordered_map<std::string, int> index_by_pkgbase_;
+  NameIndex index_by_pkgname_;
+  NameIndex index_by_pkgbase_;
 };
 
 }  // namespace auracle
@@ -71,11 +71,7 @@ TEST(PackageCacheTest, LooksUpPackages) {
 }
 
 aur::Dependency MakeDependency(const std::string& name) {
-  aur::Dependency d;
-  d.name = name;
-  d.depstring = name;
-
-  return d;
+  return aur::Dependency(name);
 }
 
 TEST(PackageCacheTest, WalkDependencies) {
@@ -113,9 +109,9 @@ TEST(PackageCacheTest, WalkDependencies) {
   std::vector<const aur::Package*> aur_packages;
   cache.WalkDependencies(
       "pkgfile-git",
-      [&](const std::string& name, const aur::Package* pkg,
+      [&](std::string_view name, const aur::Package* pkg,
           const std::vector<std::string>&) {
-        walked_packages.push_back(name);
+        walked_packages.emplace_back(name);
         if (pkg != nullptr) {
           aur_packages.push_back(pkg);
         }
@@ -137,6 +133,43 @@ TEST(PackageCacheTest, WalkDependencies) {
                                    Field(&aur::Package::name, "pacman-git")));
 }
 
+TEST(PackageCacheTest, WalkDependenciesSharesVisitedStateAcrossRoots) {
+  auracle::PackageCache cache;
+  {
+    aur::Package package;
+    package.package_id = 534055;
+    package.name = "pkgfile-git";
+    package.pkgbase_id = 60915;
+    package.pkgbase = "pkgfile-git";
+    package.depends = {MakeDependency("libarchive"),
+                       MakeDependency("pacman-git")};
+    cache.AddPackage(package);
+  }
+  {
+    aur::Package package;
+    package.package_id = 600011;
+    package.name = "pacman-git";
+    package.pkgbase_id = 29937;
+    package.pkgbase = "pacman-git";
+    package.depends = {MakeDependency("libarchive"), MakeDependency("curl")};
+    cache.AddPackage(package);
+  }
+
+  std::vector<std::string> walked_packages;
+  cache.WalkDependencies(
+      std::vector<std::string>{"pkgfile-git", "pacman-git"},
+      [&](std::string_view name, const aur::Package*,
+          const std::vector<std::string>&) {
+        walked_packages.emplace_back(name);
+      },
+      std::set<auracle::DependencyKind>{auracle::DependencyKind::Depend});
+
+  // The pacman-git subtree was already reported during the pkgfile-git walk
+  // and must not be reported again for the second root.
+  EXPECT_THAT(walked_packages, ElementsAre("libarchive", "curl", "pacman-git",
+                                           "pkgfile-git"));
+}
+
 TEST(PackageCacheTest, WalkDependenciesWithLimitedDeps) {
   auracle::PackageCache cache;
   {
@@ -171,10 +204,10 @@ TEST(PackageCacheTest, WalkDependenciesWithLimitedDeps) {
   std::vector<std::string> walked_packages;
   std::vector<const aur::Package*> aur_packages;
 
-  auto walk_dependencies_fn = [&](const std::string& name,
+  auto walk_dependencies_fn = [&](std::string_view name,
                                   const aur::Package* pkg,
                                   const std::vector<std::string>&) {
-    walked_packages.push_back(name);
+    walked_packages.emplace_back(name);
     if (pkg != nullptr) {
       aur_packages.push_back(pkg);
     }
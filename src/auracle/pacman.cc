@@ -2,12 +2,17 @@
 
 #include <fnmatch.h>
 #include <glob.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace std {
@@ -42,12 +47,20 @@ bool IsSection(const std::string& s) {
   return s.size() > 2 && s[0] == '[' && s[s.size() - 1] == ']';
 }
 
+// Version-constrained depstrings need alpm's version comparison logic; only
+// plain names can be answered from the provider indexes.
+bool IsVersionedDepstring(const std::string& package) {
+  return package.find_first_of("<=>") != std::string::npos;
+}
+
 }  // namespace
 
 namespace auracle {
 
-Pacman::Pacman(alpm_handle_t* alpm)
-    : alpm_(alpm), local_db_(alpm_get_localdb(alpm_)) {}
+Pacman::Pacman(alpm_handle_t* alpm, std::vector<std::string> repos)
+    : alpm_(alpm),
+      local_db_(alpm_get_localdb(alpm_)),
+      repos_(std::move(repos)) {}
 
 Pacman::~Pacman() { alpm_release(alpm_); }
 
@@ -58,10 +71,128 @@ struct ParseState {
 
   std::string section;
   std::vector<std::string> repos;
+
+  // Everything the parse result depends on, with mtimes. Directories named
+  // by Include globs are tracked too, so a file appearing in one of them
+  // invalidates a cached parse.
+  std::vector<std::pair<std::string, long>> sources;
 };
 
+namespace {
+
+long MTimeOf(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 ? st.st_mtime : -1;
+}
+
+std::string ConfigCachePath() {
+  if (const char* cache_home = getenv("XDG_CACHE_HOME");
+      cache_home != nullptr && *cache_home != '\0') {
+    return std::string(cache_home) + "/auracle/pacmanconf.cache";
+  }
+
+  if (const char* home = getenv("HOME");
+      home != nullptr && *home != '\0') {
+    return std::string(home) + "/.cache/auracle/pacmanconf.cache";
+  }
+
+  return std::string();
+}
+
+// The cache is a line-oriented snapshot of ParseState, keyed by the config
+// file's path and the mtimes of everything the parse read. Any mismatch
+// means a miss, after which the config is reparsed and the cache rewritten.
+bool LoadCachedParseState(const std::string& cache_path,
+                          const std::string& config_file, ParseState* state) {
+  if (cache_path.empty()) {
+    return false;
+  }
+
+  std::ifstream file(cache_path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  // Paths may contain spaces, so each directive's value is everything after
+  // the space following the last fixed field.
+  const auto rest = [](std::istringstream& iss) {
+    std::string value;
+    std::getline(iss >> std::ws, value);
+    return value;
+  };
+
+  bool config_matched = false;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+
+    std::string directive;
+    iss >> directive;
+
+    if (directive == "config") {
+      config_matched = rest(iss) == config_file;
+      if (!config_matched) {
+        return false;
+      }
+    } else if (directive == "source") {
+      long mtime;
+      iss >> mtime;
+      if (MTimeOf(rest(iss)) != mtime) {
+        return false;
+      }
+    } else if (directive == "dbpath") {
+      state->dbpath = rest(iss);
+    } else if (directive == "rootdir") {
+      state->rootdir = rest(iss);
+    } else if (directive == "repo") {
+      state->repos.push_back(rest(iss));
+    }
+  }
+
+  return config_matched;
+}
+
+void SaveCachedParseState(const std::string& cache_path,
+                          const std::string& config_file,
+                          const ParseState& state) {
+  if (cache_path.empty()) {
+    return;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(
+      std::filesystem::path(cache_path).parent_path(), ec);
+
+  const std::string tmp_path =
+      cache_path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream file(tmp_path, std::ofstream::trunc);
+    if (!file.is_open()) {
+      return;
+    }
+
+    file << "config " << config_file << "\n";
+    for (const auto& [path, mtime] : state.sources) {
+      file << "source " << mtime << " " << path << "\n";
+    }
+    file << "dbpath " << state.dbpath << "\n";
+    file << "rootdir " << state.rootdir << "\n";
+    for (const auto& repo : state.repos) {
+      file << "repo " << repo << "\n";
+    }
+  }
+
+  std::filesystem::rename(tmp_path, cache_path, ec);
+  if (ec) {
+    std::filesystem::remove(tmp_path, ec);
+  }
+}
+
+}  // namespace
+
 bool ParseOneFile(const std::string& path, ParseState* state) {
   std::ifstream file(path);
+  state->sources.emplace_back(path, MTimeOf(path));
 
   std::string line;
   while (std::getline(file, line)) {
@@ -105,6 +236,12 @@ bool ParseOneFile(const std::string& path, ParseState* state) {
         return false;
       }
 
+      if (const auto slash = value.find_last_of('/');
+          slash != std::string::npos) {
+        const auto dir = value.substr(0, slash);
+        state->sources.emplace_back(dir, MTimeOf(dir));
+      }
+
       for (size_t i = 0; i < globbuf->gl_pathc; ++i) {
         if (!ParseOneFile(globbuf->gl_pathv[i], state)) {
           return false;
@@ -122,8 +259,13 @@ bool ParseOneFile(const std::string& path, ParseState* state) {
 std::unique_ptr<Pacman> Pacman::NewFromConfig(const std::string& config_file) {
   ParseState state;
 
-  if (!ParseOneFile(config_file, &state)) {
-    return nullptr;
+  const auto cache_path = ConfigCachePath();
+  if (!LoadCachedParseState(cache_path, config_file, &state)) {
+    if (!ParseOneFile(config_file, &state)) {
+      return nullptr;
+    }
+
+    SaveCachedParseState(cache_path, config_file, state);
   }
 
   alpm_errno_t err;
@@ -132,15 +274,67 @@ std::unique_ptr<Pacman> Pacman::NewFromConfig(const std::string& config_file) {
     return nullptr;
   }
 
-  for (const auto& repo : state.repos) {
-    alpm_register_syncdb(state.alpm, repo.c_str(),
+  return std::unique_ptr<Pacman>(
+      new Pacman(state.alpm, std::move(state.repos)));
+}
+
+void Pacman::EnsureSyncDbs() const {
+  if (sync_dbs_registered_) {
+    return;
+  }
+  sync_dbs_registered_ = true;
+
+  for (const auto& repo : repos_) {
+    alpm_register_syncdb(alpm_, repo.c_str(),
                          static_cast<alpm_siglevel_t>(0));
   }
+}
+
+void Pacman::EnsureSatisfierIndexes() const {
+  if (indexes_built_) {
+    return;
+  }
+  indexes_built_ = true;
+
+  EnsureSyncDbs();
 
-  return std::unique_ptr<Pacman>(new Pacman(state.alpm));
+  for (auto i = alpm_get_syncdbs(alpm_); i != nullptr; i = i->next) {
+    auto db = static_cast<alpm_db_t*>(i->data);
+    const std::string repo = alpm_db_get_name(db);
+
+    for (auto p = alpm_db_get_pkgcache(db); p != nullptr; p = p->next) {
+      auto pkg = static_cast<alpm_pkg_t*>(p->data);
+
+      // emplace keeps the first repo seen for a name, matching the scan
+      // order alpm_find_satisfier would have used.
+      sync_provider_repo_.emplace(alpm_pkg_get_name(pkg), repo);
+      for (auto d = alpm_pkg_get_provides(pkg); d != nullptr; d = d->next) {
+        sync_provider_repo_.emplace(
+            static_cast<alpm_depend_t*>(d->data)->name, repo);
+      }
+    }
+  }
+
+  for (auto p = alpm_db_get_pkgcache(local_db_); p != nullptr; p = p->next) {
+    auto pkg = static_cast<alpm_pkg_t*>(p->data);
+
+    local_providers_.emplace(alpm_pkg_get_name(pkg));
+    for (auto d = alpm_pkg_get_provides(pkg); d != nullptr; d = d->next) {
+      local_providers_.emplace(static_cast<alpm_depend_t*>(d->data)->name);
+    }
+  }
 }
 
 std::string Pacman::RepoForPackage(const std::string& package) const {
+  if (!IsVersionedDepstring(package)) {
+    EnsureSatisfierIndexes();
+
+    const auto iter = sync_provider_repo_.find(package);
+    return iter != sync_provider_repo_.end() ? iter->second : std::string();
+  }
+
+  EnsureSyncDbs();
+
   for (auto i = alpm_get_syncdbs(alpm_); i != nullptr; i = i->next) {
     auto db = static_cast<alpm_db_t*>(i->data);
     auto pkgcache = alpm_db_get_pkgcache(db);
@@ -154,6 +348,11 @@ std::string Pacman::RepoForPackage(const std::string& package) const {
 }
 
 bool Pacman::DependencyIsSatisfied(const std::string& package) const {
+  if (!IsVersionedDepstring(package)) {
+    EnsureSatisfierIndexes();
+    return local_providers_.count(package) > 0;
+  }
+
   auto* cache = alpm_db_get_pkgcache(local_db_);
   return alpm_find_satisfier(cache, package.c_str()) != nullptr;
 }
@@ -168,16 +367,12 @@ std::optional<Pacman::Package> Pacman::GetLocalPackage(
   return Package{alpm_pkg_get_name(pkg), alpm_pkg_get_version(pkg)};
 }
 
-std::vector<Pacman::Package> Pacman::LocalPackages() const {
-  std::vector<Package> packages;
-
+void Pacman::ForEachLocalPackage(const LocalPackageVisitor& visitor) const {
   for (auto i = alpm_db_get_pkgcache(local_db_); i != nullptr; i = i->next) {
     const auto pkg = static_cast<alpm_pkg_t*>(i->data);
 
-    packages.emplace_back(alpm_pkg_get_name(pkg), alpm_pkg_get_version(pkg));
+    visitor(alpm_pkg_get_name(pkg), alpm_pkg_get_version(pkg));
   }
-
-  return packages;
 }
 
 // static
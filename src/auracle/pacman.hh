@@ -3,9 +3,13 @@
 
 #include <alpm.h>
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace auracle {
@@ -42,14 +46,35 @@ class Pacman {
 
   bool DependencyIsSatisfied(const std::string& package) const;
 
-  std::vector<Package> LocalPackages() const;
+  // Invokes the visitor with each local package's name and version. The
+  // views point into alpm-owned storage and are only valid for the duration
+  // of the call, but the enumeration itself allocates nothing.
+  using LocalPackageVisitor =
+      std::function<void(std::string_view name, std::string_view version)>;
+  void ForEachLocalPackage(const LocalPackageVisitor& visitor) const;
+
   std::optional<Package> GetLocalPackage(const std::string& name) const;
 
  private:
-  Pacman(alpm_handle_t* alpm);
+  Pacman(alpm_handle_t* alpm, std::vector<std::string> repos);
+
+  void EnsureSyncDbs() const;
+  void EnsureSatisfierIndexes() const;
 
   alpm_handle_t* alpm_;
   alpm_db_t* local_db_;
+
+  // Sync databases are registered on first use. Commands that never consult
+  // repos (e.g. search) skip the registration cost entirely.
+  std::vector<std::string> repos_;
+  mutable bool sync_dbs_registered_ = false;
+
+  // Lazily built indexes over package and provider names, making unversioned
+  // satisfier queries O(1) instead of a scan over every pkgcache. Versioned
+  // queries still go through alpm_find_satisfier.
+  mutable bool indexes_built_ = false;
+  mutable std::unordered_map<std::string, std::string> sync_provider_repo_;
+  mutable std::unordered_set<std::string> local_providers_;
 };
 
 }  // namespace auracle
@@ -0,0 +1,146 @@
+// Offline replay benchmark. Feeds a recorded RPC response body through the
+// real pipeline -- RpcResponse parsing, PackageCache insertion, dependency
+// walking, sorting, formatting -- and reports per-stage timing. No network
+// is involved, so runs isolate auracle's CPU cost from AUR latency and are
+// comparable between releases.
+//
+// The input is any recorded response body: a file from the --cachedir
+// response cache, or a decompressed packages-meta-ext-v1.json dump (the
+// parser accepts both the RPC envelope and the bare package array).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "aur/response.hh"
+#include "auracle/dependency_kind.hh"
+#include "auracle/format.hh"
+#include "auracle/package_cache.hh"
+#include "auracle/sort.hh"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class StageTimes {
+ public:
+  template <typename Fn>
+  void Run(const std::string& stage, Fn fn) {
+    const auto start = Clock::now();
+    fn();
+    const auto elapsed =
+        std::chrono::duration<double, std::milli>(Clock::now() - start);
+
+    const auto iter =
+        std::find(stages_.begin(), stages_.end(), stage) - stages_.begin();
+    if (iter == static_cast<long>(stages_.size())) {
+      stages_.push_back(stage);
+      totals_.push_back(0);
+    }
+    totals_[iter] += elapsed.count();
+  }
+
+  void Report(int iterations) const {
+    for (size_t i = 0; i < stages_.size(); ++i) {
+      fprintf(stdout, "  %-20s %10.3f ms\n", stages_[i].c_str(),
+              totals_[i] / iterations);
+    }
+    fprintf(stdout, "  %-20s %10.3f ms\n", "total",
+            std::accumulate(totals_.begin(), totals_.end(), 0.0) / iterations);
+  }
+
+ private:
+  std::vector<std::string> stages_;
+  std::vector<double> totals_;
+};
+
+bool ReadFile(const std::string& path, std::string* bytes) {
+  std::ifstream file(path, std::ifstream::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::stringstream ss;
+  ss << file.rdbuf();
+  *bytes = ss.str();
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "usage: auracle-benchmark RESPONSE_FILE [ITERATIONS]\n";
+    return 1;
+  }
+
+  std::string bytes;
+  if (!ReadFile(argv[1], &bytes)) {
+    std::cerr << "error: failed to read " << argv[1] << "\n";
+    return 1;
+  }
+
+  const int iterations = argc == 3 ? std::max(1, atoi(argv[2])) : 10;
+
+  const std::set<auracle::DependencyKind> all_kinds = {
+      auracle::DependencyKind::Depend,
+      auracle::DependencyKind::MakeDepend,
+      auracle::DependencyKind::CheckDepend,
+  };
+
+  StageTimes times;
+  int packages = 0;
+
+  for (int i = 0; i < iterations; ++i) {
+    aur::RpcResponse response;
+    times.Run("parse", [&] { response = aur::RpcResponse(bytes); });
+    packages = response.results.size();
+
+    auracle::PackageCache cache;
+    times.Run("cache insert", [&] {
+      for (const auto& package : response.results) {
+        cache.AddPackage(package);
+      }
+    });
+
+    std::vector<std::string> names;
+    names.reserve(response.results.size());
+    for (const auto& package : response.results) {
+      names.push_back(package.name);
+    }
+
+    times.Run("dependency walk", [&] {
+      cache.WalkDependencies(
+          names,
+          [](std::string_view, const aur::Package*,
+             const std::vector<std::string>&) {},
+          all_kinds);
+    });
+
+    times.Run("sort", [&] {
+      std::sort(response.results.begin(), response.results.end(),
+                sort::MakePackageSorter("name", sort::OrderBy::ORDER_ASC));
+    });
+
+    std::string out;
+    times.Run("format", [&] {
+      for (const auto& package : response.results) {
+        format::ShortTo(&out, package, std::nullopt);
+      }
+    });
+  }
+
+  std::cout << packages << " packages, " << iterations << " iterations\n";
+  times.Report(iterations);
+
+  return 0;
+}
+
+/* vim: set et ts=2 sw=2: */
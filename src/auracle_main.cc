@@ -1,9 +1,14 @@
 #include <getopt.h>
 
+#include <cerrno>
+#include <chrono>
 #include <clocale>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 #include "auracle/auracle.hh"
+#include "auracle/daemon.hh"
 #include "auracle/format.hh"
 #include "auracle/sort.hh"
 #include "auracle/terminal.hh"
@@ -18,6 +23,15 @@ struct Flags {
 
   std::string baseurl = std::string(kAurBaseurl);
   std::string pacman_config = std::string(kPacmanConf);
+  std::string cachedir;
+  std::chrono::seconds cache_ttl = std::chrono::minutes(5);
+  std::string localdump;
+  bool use_rpc_post = true;
+  int max_clone_jobs = 5;
+  int clone_depth = 0;
+  std::string clone_reference;
+  std::string socket_path;
+  bool stats = false;
   terminal::WantColor color = terminal::WantColor::AUTO;
 
   auracle::Auracle::CommandOptions command_options;
@@ -42,12 +56,28 @@ struct Flags {
       "      --resolve-deps=DEPS  Include/exclude dependency types in "
       "recursive operations\n"
       "      --show-file=FILE     File to dump with 'show' command\n"
+      "      --cachedir=DIR       Cache RPC responses on disk in DIR\n"
+      "      --cache-ttl=SECONDS  Lifetime of cached RPC responses\n"
+      "      --clone-depth=N      Clone with truncated history (0 for full "
+      "history)\n"
+      "      --devel              Probe VCS package remotes when updating\n"
+      "      --clone-reference=DIR\n"
+      "                           Borrow git objects from a local repo when "
+      "cloning\n"
+      "      --localdump=FILE     Answer queries from an AUR metadata dump\n"
+      "      --max-clones=N       Limit concurrent git clones (0 for no "
+      "limit)\n"
+      "      --rpc-get            Send RPC queries as GETs instead of POSTs\n"
+      "      --socket=PATH        Send the command to a running daemon\n"
+      "      --stats              Print transfer timing statistics to "
+      "stderr\n"
       "  -C DIR, --chdir=DIR      Change directory to DIR before cloning\n"
       "  -F FMT, --format=FMT     Specify custom output for search and info\n"
       "\n"
       "Commands:\n"
       "  buildorder               Show build order\n"
       "  clone                    Clone or update git repos for packages\n"
+      "  daemon                   Serve commands from a resident process\n"
       "  info                     Show detailed information\n"
       "  outdated                 Check for updates for foreign packages\n"
       "  rawinfo                  Dump unformatted JSON for info query\n"
@@ -76,6 +106,16 @@ bool Flags::ParseFromArgv(int* argc, char*** argv) {
     ARG_PACMAN_CONFIG,
     ARG_SHOW_FILE,
     ARG_RESOLVE_DEPS,
+    ARG_CACHEDIR,
+    ARG_CACHE_TTL,
+    ARG_LOCALDUMP,
+    ARG_MAX_CLONES,
+    ARG_CLONE_DEPTH,
+    ARG_CLONE_REFERENCE,
+    ARG_SOCKET,
+    ARG_STATS,
+    ARG_DEVEL,
+    ARG_RPC_GET,
   };
 
   static constexpr struct option opts[] = {
@@ -83,13 +123,23 @@ bool Flags::ParseFromArgv(int* argc, char*** argv) {
       { "help",            no_argument,       nullptr, 'h' },
       { "quiet",           no_argument,       nullptr, 'q' },
       { "recurse",         no_argument,       nullptr, 'r' },
+      { "cachedir",        required_argument, nullptr, ARG_CACHEDIR },
+      { "cache-ttl",       required_argument, nullptr, ARG_CACHE_TTL },
       { "chdir",           required_argument, nullptr, 'C' },
+      { "clone-depth",     required_argument, nullptr, ARG_CLONE_DEPTH },
+      { "clone-reference", required_argument, nullptr, ARG_CLONE_REFERENCE },
       { "color",           required_argument, nullptr, ARG_COLOR },
+      { "devel",           no_argument,       nullptr, ARG_DEVEL },
       { "literal",         no_argument,       nullptr, ARG_LITERAL },
+      { "localdump",       required_argument, nullptr, ARG_LOCALDUMP },
+      { "max-clones",      required_argument, nullptr, ARG_MAX_CLONES },
       { "resolve-deps",    required_argument, nullptr, ARG_RESOLVE_DEPS },
+      { "rpc-get",         no_argument,       nullptr, ARG_RPC_GET },
       { "rsort",           required_argument, nullptr, ARG_RSORT },
       { "searchby",        required_argument, nullptr, ARG_SEARCHBY },
       { "show-file",       required_argument, nullptr, ARG_SHOW_FILE },
+      { "socket",          required_argument, nullptr, ARG_SOCKET },
+      { "stats",           no_argument,       nullptr, ARG_STATS },
       { "sort",            required_argument, nullptr, ARG_SORT },
       { "version",         no_argument,       nullptr, ARG_VERSION },
       { "format",          required_argument, nullptr, 'F' },
@@ -185,6 +235,60 @@ bool Flags::ParseFromArgv(int* argc, char*** argv) {
       case ARG_BASEURL:
         baseurl = optarg;
         break;
+      case ARG_CACHEDIR:
+        cachedir = optarg;
+        break;
+      case ARG_LOCALDUMP:
+        localdump = optarg;
+        break;
+      case ARG_CACHE_TTL: {
+        char* end;
+        const long ttl = strtol(optarg, &end, 10);
+        if (*end != '\0' || ttl < 0) {
+          std::cerr << "error: invalid arg to --cache-ttl: " << sv_optarg
+                    << "\n";
+          return false;
+        }
+        cache_ttl = std::chrono::seconds(ttl);
+        break;
+      }
+      case ARG_CLONE_DEPTH: {
+        char* end;
+        const long depth = strtol(optarg, &end, 10);
+        if (*end != '\0' || depth < 0) {
+          std::cerr << "error: invalid arg to --clone-depth: " << sv_optarg
+                    << "\n";
+          return false;
+        }
+        clone_depth = depth;
+        break;
+      }
+      case ARG_CLONE_REFERENCE:
+        clone_reference = optarg;
+        break;
+      case ARG_SOCKET:
+        socket_path = optarg;
+        break;
+      case ARG_STATS:
+        stats = true;
+        break;
+      case ARG_DEVEL:
+        command_options.devel = true;
+        break;
+      case ARG_RPC_GET:
+        use_rpc_post = false;
+        break;
+      case ARG_MAX_CLONES: {
+        char* end;
+        const long jobs = strtol(optarg, &end, 10);
+        if (*end != '\0' || jobs < 0) {
+          std::cerr << "error: invalid arg to --max-clones: " << sv_optarg
+                    << "\n";
+          return false;
+        }
+        max_clone_jobs = jobs;
+        break;
+      }
       case ARG_PACMAN_CONFIG:
         pacman_config = optarg;
         break;
@@ -221,6 +325,20 @@ int main(int argc, char** argv) {
   std::setlocale(LC_ALL, "");
   terminal::Init(flags.color);
 
+  const std::string_view action(argv[1]);
+  const std::vector<std::string> args(argv + 2, argv + argc);
+
+  // With an explicit --socket, hand the command to a resident daemon and
+  // skip all local setup. If no daemon is reachable there, fall through and
+  // run the command in-process.
+  if (!flags.socket_path.empty() && action != "daemon") {
+    if (const auto status =
+            auracle::QueryDaemon(flags.socket_path, action, args);
+        status.has_value()) {
+      return *status < 0 ? 1 : 0;
+    }
+  }
+
   const auto pacman = auracle::Pacman::NewFromConfig(flags.pacman_config);
   if (pacman == nullptr) {
     std::cerr << "error: failed to parse " << flags.pacman_config << "\n";
@@ -229,10 +347,14 @@ int main(int argc, char** argv) {
 
   auracle::Auracle auracle(auracle::Auracle::Options()
                                .set_aur_baseurl(flags.baseurl)
-                               .set_pacman(pacman.get()));
-
-  const std::string_view action(argv[1]);
-  const std::vector<std::string> args(argv + 2, argv + argc);
+                               .set_pacman(pacman.get())
+                               .set_cachedir(flags.cachedir)
+                               .set_cache_ttl(flags.cache_ttl)
+                               .set_localdump(flags.localdump)
+                               .set_use_rpc_post(flags.use_rpc_post)
+                               .set_max_clone_jobs(flags.max_clone_jobs)
+                               .set_clone_depth(flags.clone_depth)
+                               .set_clone_reference(flags.clone_reference));
 
   const std::unordered_map<std::string_view,
                            int (auracle::Auracle::*)(
@@ -254,13 +376,54 @@ int main(int argc, char** argv) {
           // clang-format on
       };
 
+  if (action == "daemon") {
+    auracle::Daemon daemon([&](const std::string& command,
+                               const std::vector<std::string>& command_args) {
+      const auto iter = cmds.find(command);
+      if (iter == cmds.end()) {
+        std::cerr << "Unknown action " << command << "\n";
+        return -EINVAL;
+      }
+
+      return (auracle.*iter->second)(command_args, flags.command_options);
+    });
+
+    const auto socket_path = flags.socket_path.empty()
+                                 ? auracle::DefaultSocketPath()
+                                 : flags.socket_path;
+    if (const int r = daemon.Run(socket_path); r < 0) {
+      std::cerr << "error: failed to listen on " << socket_path << ": "
+                << strerror(-r) << "\n";
+      return 1;
+    }
+
+    return 0;
+  }
+
   const auto iter = cmds.find(action);
   if (iter == cmds.end()) {
     std::cerr << "Unknown action " << action << "\n";
     return 1;
   }
 
-  return (auracle.*iter->second)(args, flags.command_options) < 0 ? 1 : 0;
+  const int r = (auracle.*iter->second)(args, flags.command_options);
+
+  if (flags.stats) {
+    const auto stats = auracle.RequestStats();
+    const auto ms = [](std::chrono::microseconds us) {
+      return us.count() / 1000.0;
+    };
+
+    fprintf(stderr, "stats: %d requests, %ld bytes received\n", stats.requests,
+            stats.bytes_received);
+    fprintf(stderr,
+            "stats: namelookup %.1fms, connect %.1fms, tls %.1fms, "
+            "starttransfer %.1fms, total %.1fms\n",
+            ms(stats.namelookup), ms(stats.connect), ms(stats.appconnect),
+            ms(stats.starttransfer), ms(stats.total));
+  }
+
+  return r < 0 ? 1 : 0;
 }
 
 /* vim: set et ts=2 sw=2: */
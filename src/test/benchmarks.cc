@@ -0,0 +1,174 @@
+// Micro-benchmarks for the hot paths in libaur and libauracle, driven by the
+// checked-in fake AUR fixtures so inputs are shaped and sized like real
+// responses. Built when the google-benchmark dependency is found; run with
+// `meson test --benchmark` or invoke the binary directly.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "aur/request.hh"
+#include "aur/response.hh"
+#include "auracle/dependency_kind.hh"
+#include "auracle/format.hh"
+#include "auracle/package_cache.hh"
+#include "auracle/sort.hh"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string ReadFile(const fs::path& path) {
+  std::ifstream file(path, std::ifstream::binary);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+// A real ~90KB search response with 100 packages.
+const std::string& SearchFixture() {
+  static const std::string& bytes =
+      *new std::string(ReadFile(fs::path(FIXTURE_DIR) / "search"
+                                / "name-desc|systemd"));
+  return bytes;
+}
+
+const std::vector<aur::Package>& SearchPackages() {
+  static const auto& packages = *new std::vector<aur::Package>(
+      aur::RpcResponse(SearchFixture()).results);
+  return packages;
+}
+
+// Every info fixture, parsed and flattened. Unlike search responses these
+// carry dependency fields, so they feed the cache and walk benchmarks.
+const std::vector<aur::Package>& InfoPackages() {
+  static const auto& packages = *new std::vector<aur::Package>([] {
+    std::vector<aur::Package> packages;
+    for (const auto& entry :
+         fs::directory_iterator(fs::path(FIXTURE_DIR) / "info")) {
+      aur::RpcResponse response(ReadFile(entry.path()));
+      std::move(response.results.begin(), response.results.end(),
+                std::back_inserter(packages));
+    }
+    return packages;
+  }());
+  return packages;
+}
+
+const std::set<auracle::DependencyKind>& AllDependencyKinds() {
+  static const auto& kinds = *new std::set<auracle::DependencyKind>{
+      auracle::DependencyKind::Depend,
+      auracle::DependencyKind::MakeDepend,
+      auracle::DependencyKind::CheckDepend,
+  };
+  return kinds;
+}
+
+void BM_RpcResponseParse(benchmark::State& state) {
+  const auto& bytes = SearchFixture();
+
+  for (auto _ : state) {
+    aur::RpcResponse response(bytes);
+    benchmark::DoNotOptimize(response.results.data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_RpcResponseParse);
+
+void BM_PackageCacheAddPackage(benchmark::State& state) {
+  const auto& packages = SearchPackages();
+
+  for (auto _ : state) {
+    auracle::PackageCache cache;
+    for (const auto& package : packages) {
+      cache.AddPackage(package);
+    }
+    benchmark::DoNotOptimize(cache.size());
+  }
+
+  state.SetItemsProcessed(state.iterations() * packages.size());
+}
+BENCHMARK(BM_PackageCacheAddPackage);
+
+void BM_PackageCacheWalkDependencies(benchmark::State& state) {
+  auracle::PackageCache cache;
+  for (const auto& package : InfoPackages()) {
+    cache.AddPackage(package);
+  }
+
+  // Acyclic roots only; walking the python-font* fixtures would print a
+  // cycle warning on every iteration.
+  const std::vector<std::string> names = {
+      "google-drive-ocamlfuse",
+      "auracle-git",
+      "pkgfile-git",
+  };
+
+  for (auto _ : state) {
+    int visited = 0;
+    cache.WalkDependencies(
+        names,
+        [&visited](std::string_view, const aur::Package*,
+                   const std::vector<std::string>&) { ++visited; },
+        AllDependencyKinds());
+    benchmark::DoNotOptimize(visited);
+  }
+}
+BENCHMARK(BM_PackageCacheWalkDependencies);
+
+void BM_PackageSorter(benchmark::State& state) {
+  const auto sorter =
+      sort::MakePackageSorter("popularity", sort::OrderBy::ORDER_ASC);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto packages = SearchPackages();
+    state.ResumeTiming();
+
+    std::sort(packages.begin(), packages.end(), sorter);
+    benchmark::DoNotOptimize(packages.data());
+  }
+}
+BENCHMARK(BM_PackageSorter);
+
+void BM_RpcRequestBuild(benchmark::State& state) {
+  aur::InfoRequest request;
+  for (const auto& package : SearchPackages()) {
+    request.AddArg(package.name);
+  }
+
+  for (auto _ : state) {
+    auto uris = request.Build("https://aur.archlinux.org");
+    benchmark::DoNotOptimize(uris.data());
+  }
+}
+BENCHMARK(BM_RpcRequestBuild);
+
+void BM_FormatCustom(benchmark::State& state) {
+  const std::string format = "{name} {version} ({votes}, {popularity})";
+  const auto& packages = SearchPackages();
+
+  for (auto _ : state) {
+    std::string out;
+    for (const auto& package : packages) {
+      format::CustomTo(&out, format, package);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * packages.size());
+}
+BENCHMARK(BM_FormatCustom);
+
+}  // namespace
+
+BENCHMARK_MAIN();
+
+/* vim: set et ts=2 sw=2: */
@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+
+import auracle_test
+import os
+import os.path
+import subprocess
+import time
+
+
+class TestDaemon(auracle_test.TestCase):
+
+    def setUp(self):
+        super().setUp()
+
+        self.socket_path = os.path.join(self.tempdir, 'auracle.sock')
+
+        env = {
+            'PATH': '{}/fakeaur:{}'.format(
+                os.path.dirname(os.path.realpath(__file__)),
+                os.getenv('PATH')),
+            'AURACLE_TEST_TMPDIR': self.tempdir,
+            'LC_TIME': 'C',
+            'TZ': 'UTC',
+        }
+
+        self.daemon = subprocess.Popen([
+            os.path.join(self.build_dir, 'auracle'),
+            '--baseurl', self.baseurl,
+            '--color=never',
+            '--pacmanconfig={}/pacman.conf'.format(self.tempdir),
+            '--chdir', self.tempdir,
+            '--socket', self.socket_path,
+            'daemon',
+        ], env=env)
+
+        for _ in range(100):
+            if os.path.exists(self.socket_path):
+                break
+            time.sleep(0.01)
+
+
+    def tearDown(self):
+        if self.daemon.poll() is None:
+            self.daemon.terminate()
+            self.daemon.wait()
+        super().tearDown()
+
+
+    def testQueryRoundTrip(self):
+        r = self.Auracle(['--socket', self.socket_path, 'search', 'aura'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertIn('aur/auracle-git', r.process.stdout.decode())
+
+        # The query was answered by the daemon; the client itself made no
+        # requests of the AUR.
+        self.assertCountEqual(r.request_uris, [])
+
+
+    def testReplaysStderrAndStatus(self):
+        r = self.Auracle(
+                ['--socket', self.socket_path, 'clone', 'packagenotfoundbro'])
+        self.assertNotEqual(r.process.returncode, 0)
+        self.assertEqual('no results found for packagenotfoundbro\n',
+                r.process.stderr.decode())
+
+
+    def testArgumentWithEmbeddedSpaces(self):
+        # The argument must arrive at the daemon as a single word, not be
+        # re-tokenized into three.
+        r = self.Auracle(
+                ['--socket', self.socket_path, 'clone', 'not a package'])
+        self.assertNotEqual(r.process.returncode, 0)
+        self.assertEqual('no results found for not a package\n',
+                r.process.stderr.decode())
+
+
+    def testQuit(self):
+        r = self.Auracle(['--socket', self.socket_path, 'quit'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertEqual(0, self.daemon.wait(timeout=10))
+
+
+if __name__ == '__main__':
+    auracle_test.main()
@@ -34,6 +34,22 @@ class FakeAurHandler(http.server.BaseHTTPRequestHandler):
         return self.respond(status_code=404)
 
 
+    def do_POST(self):
+        url = urllib.parse.urlparse(self.path)
+
+        if not url.path.startswith('/rpc'):
+            return self.respond(status_code=404)
+
+        # auracle POSTs the argument list as a urlencoded body. Fold it back
+        # into the querystring so the RPC handler sees the same parameters
+        # either way.
+        body = self.rfile.read(
+                int(self.headers.get('Content-Length', 0))).decode()
+        query = '&'.join(filter(None, [url.query, body]))
+
+        return self.handle_rpc(url._replace(query=query))
+
+
     @staticmethod
     def last_of(l):
         return l[-1] if l else None
@@ -21,6 +21,18 @@ class TestInfo(auracle_test.TestCase):
         self.assertNotEqual(r.process.returncode, 0)
 
 
+    def testRpcGetFallback(self):
+        r = self.Auracle(['info', 'auracle-git'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertEqual('POST', r.requests_sent[0].command)
+
+        r = self.Auracle(['--rpc-get', 'info', 'auracle-git'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertEqual('GET', r.requests_sent[0].command)
+        self.assertListEqual(r.request_uris,
+                ['/rpc?v=5&type=info&arg[]=auracle-git'])
+
+
     def testBadResponsesFromAur(self):
         r = self.Auracle(['info', '503'])
         self.assertNotEqual(r.process.returncode, 0)
@@ -1,6 +1,8 @@
 #!/usr/bin/env python
 
 import auracle_test
+import os
+import os.path
 
 
 class TestDownload(auracle_test.TestCase):
@@ -31,5 +33,45 @@ class TestDownload(auracle_test.TestCase):
         self.assertEqual(r.process.returncode, 1)
 
 
+    def testIncrementalStateSkipsRequery(self):
+        cachedir = os.path.join(self.tempdir, 'cache')
+
+        r = self.Auracle(['outdated', '--quiet', '--cachedir', cachedir])
+        self.assertEqual(r.process.returncode, 0)
+        first_stdout = r.process.stdout
+
+        # Drop the cached RPC responses but keep the incremental state; a
+        # second run within the TTL must answer entirely from the state,
+        # without issuing any requests.
+        for entry in os.listdir(cachedir):
+            if entry != 'outdated.state':
+                os.unlink(os.path.join(cachedir, entry))
+
+        r = self.Auracle(['outdated', '--quiet', '--cachedir', cachedir])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertEqual(first_stdout, r.process.stdout)
+        self.assertCountEqual(r.request_uris, [])
+
+
+    def testIncrementalStatePrunesUninstalledPackages(self):
+        cachedir = os.path.join(self.tempdir, 'cache')
+        state_path = os.path.join(cachedir, 'outdated.state')
+
+        r = self.Auracle(['outdated', '--quiet', '--cachedir', cachedir])
+        self.assertEqual(r.process.returncode, 0)
+        with open(state_path) as f:
+            self.assertIn('auracle-git', f.read())
+
+        with open(state_path, 'a') as f:
+            f.write('notinstalled notinstalled 1-1 2-1 9999999999\n')
+
+        r = self.Auracle(['outdated', '--quiet', '--cachedir', cachedir])
+        self.assertEqual(r.process.returncode, 0)
+        with open(state_path) as f:
+            state = f.read()
+        self.assertNotIn('notinstalled', state)
+        self.assertIn('auracle-git', state)
+
+
 if __name__ == '__main__':
     auracle_test.main()
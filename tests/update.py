@@ -1,10 +1,34 @@
 #!/usr/bin/env python
 
 import auracle_test
+import os
+import os.path
 
 
 class TestDownload(auracle_test.TestCase):
 
+    def _SeedLocalClone(self, pkgbase, head):
+        gitdir = os.path.join(self.tempdir, pkgbase, '.git')
+        os.makedirs(gitdir)
+        with open(os.path.join(gitdir, 'HEAD'), 'w') as f:
+            f.write(head + '\n')
+        open(os.path.join(self.tempdir, pkgbase, 'PKGBUILD'), 'w').close()
+
+
+    def _SetRemoteHead(self, pkgbase, head):
+        with open(os.path.join(
+                self.tempdir, pkgbase + '.remote-head'), 'w') as f:
+            f.write(head)
+
+
+    def _GitInvocations(self, action):
+        path = os.path.join(self.tempdir, 'git-invocations')
+        if not os.path.exists(path):
+            return []
+        with open(path) as f:
+            return [line for line in f.read().splitlines()
+                    if line.startswith(action + ' ')]
+
     def testOutdatedFindsPackagesNeedingUpgrade(self):
         r = self.Auracle(['update', '--quiet'])
         self.assertEqual(r.process.returncode, 0)
@@ -23,5 +47,68 @@ class TestDownload(auracle_test.TestCase):
         self.assertEqual(r.process.returncode, 1)
 
 
+    def testDevelClonesWhenNoLocalCheckout(self):
+        r = self.Auracle(['update', '--devel', 'auracle-git'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertPkgbuildExists('auracle-git')
+
+        # Nothing to compare against locally, so no probe was needed.
+        self.assertEqual(0, len(self._GitInvocations('ls-remote')))
+
+
+    def testDevelProbesRemoteHead(self):
+        cachedir = os.path.join(self.tempdir, 'cache')
+        sha_a = '1' * 40
+        sha_b = '2' * 40
+        self._SeedLocalClone('pkgfile-git', sha_a)
+        self._SetRemoteHead('pkgfile-git', sha_a)
+
+        # The remote matches the local head: one probe, and the only pull is
+        # the version-outdated update itself.
+        r = self.Auracle(['update', '--devel', '--cachedir', cachedir,
+                          'pkgfile-git'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertEqual(1, len(self._GitInvocations('ls-remote')))
+        self.assertEqual(1, len(self._GitInvocations('pull')))
+
+        # Within the TTL the remembered head answers; no second probe even
+        # though the remote has moved on.
+        self._SetRemoteHead('pkgfile-git', sha_b)
+        r = self.Auracle(['update', '--devel', '--cachedir', cachedir,
+                          'pkgfile-git'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertEqual(1, len(self._GitInvocations('ls-remote')))
+        self.assertEqual(2, len(self._GitInvocations('pull')))
+
+        # Once the state expires, the probe sees the new head and pulls.
+        os.unlink(os.path.join(cachedir, 'devel-heads.state'))
+        r = self.Auracle(['update', '--devel', '--cachedir', cachedir,
+                          'pkgfile-git'])
+        self.assertEqual(r.process.returncode, 0)
+        self.assertEqual(2, len(self._GitInvocations('ls-remote')))
+        self.assertEqual(4, len(self._GitInvocations('pull')))
+
+        with open(os.path.join(cachedir, 'devel-heads.state')) as f:
+            self.assertIn('pkgfile-git ' + sha_b, f.read())
+
+
+    def testDevelEmptyProbeResultIsFailure(self):
+        cachedir = os.path.join(self.tempdir, 'cache')
+        self._SeedLocalClone('pkgfile-git', '1' * 40)
+        self._SetRemoteHead('pkgfile-git', '')
+
+        r = self.Auracle(['update', '--devel', '--cachedir', cachedir,
+                          'pkgfile-git'])
+        self.assertNotEqual(r.process.returncode, 0)
+        self.assertIn('ls-remote failed for pkgfile-git',
+                r.process.stderr.decode())
+
+        # A failed probe must not be remembered as a real head.
+        state_path = os.path.join(cachedir, 'devel-heads.state')
+        if os.path.exists(state_path):
+            with open(state_path) as f:
+                self.assertNotIn('pkgfile-git', f.read())
+
+
 if __name__ == '__main__':
     auracle_test.main()